@@ -19,6 +19,10 @@ layout(set = 0, binding = 1) uniform sampler2D u_atlas;
 
 layout(location = 0) out vec4 frag_color;
 
+// the canvas specializes one shader per font mode so the switch folds away,
+// left at -1 the mode comes from the uniform instead
+layout(constant_id = 0) const int TEXT_MODE = -1;
+
 float sdf_alpha(float dist)
 {
 	float smoothing = fwidth(dist) * 0.5;
@@ -32,7 +36,9 @@ float msdf_median(vec3 msd)
 
 void main()
 {
-	switch (u_mode)
+	int mode = TEXT_MODE >= 0 ? TEXT_MODE : u_mode;
+
+	switch (mode)
 	{
 	case MODE_SDF:
 	{
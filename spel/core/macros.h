@@ -59,6 +59,12 @@
 
 #define spel_unused(x) (void)(x)
 
+#if defined(_MSC_VER)
+#	define spel_thread_local __declspec(thread)
+#else
+#	define spel_thread_local _Thread_local
+#endif
+
 #if defined(_WIN32)
 #	define spel_platform_win 1
 #	define spel_platform "Windows"
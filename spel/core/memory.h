@@ -17,11 +17,58 @@ typedef struct spel_memory_tag_stats
 {
 	size_t bytes_current;
 	size_t bytes_peak;
+	size_t bytes_total;
 	uint64_t alloc_count;
 	uint64_t free_count;
 	uint64_t largest_block;
 } spel_memory_tag_stats;
 
+// bump allocator that lives for one frame. everything in it is dropped when
+// spel_run_frame starts the next one, so there is nothing to free
+typedef struct spel_memory_arena
+{
+	uint8_t* base;
+	size_t offset;
+	size_t capacity;
+	size_t peak;
+
+	void* spills; // blocks that didn't fit this frame, freed on reset
+	size_t spill_count;
+	size_t spill_bytes; // large spills aren't counted, they never grow the arena
+	uint32_t quiet_frames; // resets in a row that used under a quarter of capacity
+
+	uint64_t owner; // thread that is allowed to use the arena
+} spel_memory_arena;
+
+typedef struct spel_memory_frame_marker
+{
+	size_t offset;
+	size_t spill_count;
+} spel_memory_frame_marker;
+
+// fixed-size slot allocator, slots are carved out of slabs and recycled through
+// an intrusive free list. pools link themselves into spel.memory.pools
+typedef struct spel_memory_pool
+{
+	const char* name;
+	spel_memory_tag tag;
+	size_t slot_size;
+	uint32_t slots_per_slab;
+
+	void* slabs;
+	void* free_list;
+
+	uint32_t slab_count;
+	uint32_t used;
+	uint32_t peak;
+
+	struct spel_memory_pool* next;
+} spel_memory_pool;
+
+// the counters below are only filled in on the copy returned by
+// spel_memory_snapshot, allocations account into per-thread shards instead.
+// thin builds only sample allocations, so every current/peak figure and the free
+// counts stay 0 there, the totals and alloc counts are estimates
 typedef struct spel_memory
 {
 	size_t current;
@@ -36,9 +83,14 @@ typedef struct spel_memory
 	uint64_t free_count;
 
 	spel_memory_tag_stats tags[SPEL_MEM_TAG_COUNT];
+	spel_memory_arena frame;
+	spel_memory_pool* pools;
 } spel_memory;
 
+// blocks from spel_memory_malloc are zeroed in tracked builds only, ask for
+// spel_memory_calloc when you rely on it
 spel_api void* spel_memory_malloc(size_t size, spel_memory_tag tag);
+spel_api void* spel_memory_calloc(size_t count, size_t size, spel_memory_tag tag);
 spel_api void spel_memory_free(void* ptr);
 spel_api void* spel_memory_realloc(void* ptr, size_t newSize, spel_memory_tag tag);
 const spel_api char* spel_memory_fmt_size(size_t bytes, char buf[32], bool colors);
@@ -47,6 +99,37 @@ const spel_api char* spel_memory_fmt_size(size_t bytes, char buf[32], bool color
 spel_api char* spel_memory_strdup(const char* src, spel_memory_tag tag);
 
 spel_api void spel_memory_dump_terminal();
+spel_api spel_memory spel_memory_snapshot();
+
+// returns NULL when called off the main thread or outside spel_app_run,
+// callers are expected to fall back to spel_memory_malloc
+spel_api void* spel_memory_frame_alloc(size_t size);
+spel_api bool spel_memory_frame_owns(const void* ptr);
+spel_api spel_memory_frame_marker spel_memory_frame_mark();
+spel_api void spel_memory_frame_rewind(spel_memory_frame_marker marker);
+
+spel_api void spel_memory_pool_init(spel_memory_pool* pool, const char* name,
+								  size_t slotSize, uint32_t slotsPerSlab,
+								  spel_memory_tag tag);
+spel_api void spel_memory_pool_destroy(spel_memory_pool* pool);
+spel_api void* spel_memory_pool_alloc(spel_memory_pool* pool);
+spel_api void spel_memory_pool_free(spel_memory_pool* pool, void* ptr);
+
+#define spel_memory_pool_init_typed(pool, T, slotsPerSlab, tag)                         \
+	spel_memory_pool_init((pool), #T, sizeof(T), (slotsPerSlab), (tag))
+
+// call-site profiler, samples every Nth allocation and dumps folded stacks
+// (flamegraph.pl / speedscope) weighted by estimated bytes
+spel_api void spel_memory_profile_start(uint32_t sampleEvery);
+spel_api void spel_memory_profile_stop();
+spel_api bool spel_memory_profile_dump(const char* path);
+
+spel_hidden void spel_memory_profile_record(size_t size);
+spel_hidden void spel_memory_profile_shutdown();
+
+spel_hidden void spel_memory_frame_init();
+spel_hidden void spel_memory_frame_reset();
+spel_hidden void spel_memory_frame_shutdown();
 
 spel_hidden void spel_memory_sdl_setup();
 
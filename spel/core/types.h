@@ -102,6 +102,13 @@ typedef struct spel_app
 {
 	spel_gfx_backend gfx_backend;
 
+	// set in conf to keep linked shader programs on disk between runs
+	const char* program_cache_dir;
+
+	// set in conf to reload shaders from spel_gfx_shader_load whenever their
+	// spir-v changes on disk (linux only)
+	bool shader_hot_reload;
+
 	void (*conf)();
 	void (*load)();
 	void (*update)(double);
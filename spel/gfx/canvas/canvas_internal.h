@@ -303,8 +303,8 @@ typedef struct
 	int state_top;
 
 	// gfx resources
-	spel_gfx_buffer vbo;
-	spel_gfx_buffer ibo;
+	spel_gfx_ring vring;
+	spel_gfx_ring iring;
 	spel_gfx_pipeline pipeline;
 	spel_gfx_sampler sampler;
 	spel_gfx_uniform_buffer ubuffer_frame;
@@ -9,6 +9,9 @@ typedef struct spel_gfx_buffer_desc
 	spel_gfx_buffer_type type;
 	spel_gfx_buffer_usage usage;
 	spel_gfx_buffer_access access;
+	// mapped for the buffer's whole life. spel_gfx_buffer_update stays safe, but
+	// writes through the mapping aren't fenced, the gpu may still be reading that
+	// memory for a few frames. use a spel_gfx_ring for per-frame data
 	bool persistent;
 	size_t size;
 	const void* data;
@@ -31,4 +34,24 @@ spel_api void spel_gfx_buffer_unmap(spel_gfx_buffer buf);
 
 spel_api void spel_gfx_buffer_flush(spel_gfx_buffer buf, size_t offset, size_t size);
 
+// streaming ring: one persistently mapped buffer cut into a region per frame in
+// flight. a slice is only good for the frame it was taken in, but writing to it
+// never goes through the driver and never waits on the gpu
+typedef struct
+{
+	spel_gfx_buffer buffer; // bind this at `offset`
+	size_t offset;
+	void* data;
+} spel_gfx_ring_slice;
+
+spel_api spel_gfx_ring spel_gfx_ring_create(spel_gfx_context ctx,
+										  spel_gfx_buffer_type type, size_t frameSize);
+spel_api void spel_gfx_ring_destroy(spel_gfx_ring ring);
+
+// align has to be a power of two no larger than 256, or than
+// spel_gfx_uniform_alignment when the driver asks for more. grows the ring when a
+// frame outgrows it, so this only fails when the driver is out of memory
+spel_api spel_gfx_ring_slice spel_gfx_ring_alloc(spel_gfx_ring ring, size_t size,
+											   size_t align);
+
 #endif
\ No newline at end of file
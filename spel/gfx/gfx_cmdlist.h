@@ -8,10 +8,37 @@
 spel_api spel_gfx_cmdlist spel_gfx_cmdlist_create(spel_gfx_context ctx);
 spel_api spel_gfx_cmdlist spel_gfx_cmdlist_default(spel_gfx_context ctx);
 
+// secondary lists never touch gl and share nothing with other lists, so a worker
+// thread can record into one while others record into theirs. create them on the
+// main thread, then spel_gfx_cmd_execute() them into a primary list once the
+// workers are done. they replay in the order they were executed, at the primary's
+// submit, and are emptied afterwards
+spel_api spel_gfx_cmdlist spel_gfx_cmdlist_create_secondary(spel_gfx_context ctx);
+spel_api void spel_gfx_cmd_execute(spel_gfx_cmdlist cl, spel_gfx_cmdlist secondary);
+
+// bundles are secondaries that survive being replayed: record them once, then
+// execute them into other lists or submit them directly as often as needed.
+// handles are checked while recording, so whatever a bundle references has to
+// outlive it, or the bundle has to be reset and recorded again
+spel_api spel_gfx_cmdlist spel_gfx_cmdlist_create_bundle(spel_gfx_context ctx);
+
+// drops everything recorded so far
+spel_api void spel_gfx_cmdlist_reset(spel_gfx_cmdlist cmdlist);
+
 spel_api void spel_gfx_cmdlist_destroy(spel_gfx_cmdlist cmdlist);
 
 spel_api void spel_gfx_cmdlist_submit(spel_gfx_cmdlist cmdlist);
 
+// most chunks the list has needed in a single frame, for tuning
+// spel_cmdlist_chunk_size against what a frame actually records
+spel_api uint32_t spel_gfx_cmdlist_chunk_peak(spel_gfx_cmdlist cmdlist);
+
+// sorted lists reorder the draws inside a render pass by pipeline, texture and
+// depth before replaying them. blended draws keep the order they were recorded in.
+// a draw only gets the state that was bound earlier in the same list
+spel_api void spel_gfx_cmdlist_set_sorted(spel_gfx_cmdlist cmdlist, bool sorted);
+spel_api void spel_gfx_cmd_sort_depth(spel_gfx_cmdlist cl, float depth);
+
 spel_api void spel_gfx_cmd_bind_vertex(spel_gfx_cmdlist cl, uint32_t stream,
 									   spel_gfx_buffer buf, size_t offset);
 
@@ -33,6 +60,51 @@ spel_api void spel_gfx_cmd_draw(spel_gfx_cmdlist cl, uint32_t vertexCount,
 spel_api void spel_gfx_cmd_draw_indexed(spel_gfx_cmdlist cl, uint32_t indexCount,
 										uint32_t firstIndex, int32_t vertexOffset);
 
+// per-instance streams (SPEL_GFX_VERTEX_RATE_INSTANCE) advance once per instance,
+// starting at firstInstance
+spel_api void spel_gfx_cmd_draw_instanced(spel_gfx_cmdlist cl, uint32_t vertexCount,
+										  uint32_t instanceCount, uint32_t firstVertex,
+										  uint32_t firstInstance);
+
+spel_api void spel_gfx_cmd_draw_indexed_instanced(spel_gfx_cmdlist cl,
+												  uint32_t indexCount,
+												  uint32_t instanceCount,
+												  uint32_t firstIndex,
+												  int32_t vertexOffset,
+												  uint32_t firstInstance);
+
+// layouts indirect draws read out of a SPEL_GFX_BUFFER_INDIRECT buffer
+typedef struct
+{
+	uint32_t vertex_count;
+	uint32_t instance_count;
+	uint32_t first_vertex;
+	uint32_t first_instance;
+} spel_gfx_draw_indirect_args;
+
+typedef struct
+{
+	uint32_t index_count;
+	uint32_t instance_count;
+	uint32_t first_index;
+	int32_t vertex_offset;
+	uint32_t first_instance;
+} spel_gfx_draw_indexed_indirect_args;
+
+// offset has to be 4 byte aligned. the multi variants run drawCount draws whose
+// arguments are stride bytes apart (0 = tightly packed)
+spel_api void spel_gfx_cmd_draw_indirect(spel_gfx_cmdlist cl, spel_gfx_buffer buf,
+										 size_t offset);
+spel_api void spel_gfx_cmd_draw_indirect_multi(spel_gfx_cmdlist cl, spel_gfx_buffer buf,
+											   size_t offset, uint32_t drawCount,
+											   uint32_t stride);
+
+spel_api void spel_gfx_cmd_draw_indexed_indirect(spel_gfx_cmdlist cl, spel_gfx_buffer buf,
+												 size_t offset);
+spel_api void spel_gfx_cmd_draw_indexed_indirect_multi(spel_gfx_cmdlist cl,
+													   spel_gfx_buffer buf, size_t offset,
+													   uint32_t drawCount, uint32_t stride);
+
 spel_api void spel_gfx_cmd_bind_texture(spel_gfx_cmdlist cl, uint32_t slot,
 										spel_gfx_texture texture);
 
@@ -57,6 +129,36 @@ spel_api void spel_gfx_cmd_uniform_block_update(spel_gfx_cmdlist cl,
 spel_api void spel_gfx_cmd_bind_shader_buffer(spel_gfx_cmdlist cl,
 											  spel_gfx_uniform_buffer buf);
 
+// binds `block.size` bytes of `buffer` starting at `offset`, e.g. a slice from
+// spel_gfx_uniform_alloc. lets many draws share one buffer with their own constants
+spel_api void spel_gfx_cmd_bind_shader_buffer_offset(spel_gfx_cmdlist cl,
+													 spel_gfx_uniform_buffer block,
+													 spel_gfx_buffer buffer,
+													 size_t offset);
+
+// writes straight into a per-frame ring slice and binds that range, the command
+// only carries the offset. `block` only needs a location and size, see
+// spel_gfx_uniform_block_get. a short `size` gets the rest of the block zeroed.
+// primary lists only, the ring is shared so bundles and secondaries can't push
+spel_api void spel_gfx_cmd_uniform_push(spel_gfx_cmdlist cl,
+										spel_gfx_uniform_buffer block, const void* data,
+										size_t size);
+
+// compute. dispatches run the bound compute pipeline, writes they make only show
+// up to later commands after a barrier covering how those commands read them
+typedef struct
+{
+	uint32_t groups_x;
+	uint32_t groups_y;
+	uint32_t groups_z;
+} spel_gfx_dispatch_indirect_args;
+
+spel_api void spel_gfx_cmd_dispatch(spel_gfx_cmdlist cl, uint32_t groupsX, uint32_t groupsY,
+									uint32_t groupsZ);
+spel_api void spel_gfx_cmd_dispatch_indirect(spel_gfx_cmdlist cl, spel_gfx_buffer buf,
+											 size_t offset);
+spel_api void spel_gfx_cmd_barrier(spel_gfx_cmdlist cl, spel_gfx_barrier barriers);
+
 spel_api void spel_gfx_cmd_begin_pass(spel_gfx_cmdlist cl, spel_gfx_render_pass pass);
 spel_api void spel_gfx_cmd_end_pass(spel_gfx_cmdlist cl);
 
@@ -18,11 +18,19 @@ typedef enum
 	SPEL_GFX_CMD_CLEAR,
 	SPEL_GFX_CMD_DRAW,
 	SPEL_GFX_CMD_DRAW_INDEXED,
+	SPEL_GFX_CMD_DRAW_INSTANCED,
+	SPEL_GFX_CMD_DRAW_INDEXED_INSTANCED,
+	SPEL_GFX_CMD_DRAW_INDIRECT,
+	SPEL_GFX_CMD_DRAW_INDEXED_INDIRECT,
+	SPEL_GFX_CMD_DISPATCH,
+	SPEL_GFX_CMD_DISPATCH_INDIRECT,
+	SPEL_GFX_CMD_BARRIER,
 	SPEL_GFX_CMD_VIEWPORT,
 	SPEL_GFX_CMD_SCISSOR,
 	SPEL_GFX_CMD_UNIFORM_UPDATE,
 	SPEL_GFX_CMD_BEGIN_RENDER_PASS,
-	SPEL_GFX_CMD_END_RENDER_PASS
+	SPEL_GFX_CMD_END_RENDER_PASS,
+	SPEL_GFX_CMD_EXECUTE
 } spel_gfx_cmd_type;
 
 typedef struct spel_gfx_cmd_header
@@ -59,9 +67,12 @@ typedef struct spel_gfx_bind_pipeline_cmd
 	spel_gfx_pipeline pipeline;
 } spel_gfx_bind_pipeline_cmd;
 
+// every draw starts with hdr + sort_key, so the sorted replay can read the key
+// through spel_gfx_draw_cmd no matter which kind of draw it is
 typedef struct spel_gfx_draw_cmd
 {
 	spel_gfx_cmd_header hdr;
+	uint64_t sort_key; // only filled in for sorted lists
 	uint32_t vertex_count;
 	uint32_t first_vertex;
 } spel_gfx_draw_cmd;
@@ -69,11 +80,65 @@ typedef struct spel_gfx_draw_cmd
 typedef struct spel_gfx_draw_indexed_cmd
 {
 	spel_gfx_cmd_header hdr;
+	uint64_t sort_key;
 	uint32_t index_count;
 	uint32_t first_index;
 	int32_t vertex_offset;
 } spel_gfx_draw_indexed_cmd;
 
+typedef struct spel_gfx_draw_instanced_cmd
+{
+	spel_gfx_cmd_header hdr;
+	uint64_t sort_key;
+	uint32_t vertex_count;
+	uint32_t first_vertex;
+	uint32_t instance_count;
+	uint32_t first_instance;
+} spel_gfx_draw_instanced_cmd;
+
+typedef struct spel_gfx_draw_indexed_instanced_cmd
+{
+	spel_gfx_cmd_header hdr;
+	uint64_t sort_key;
+	uint32_t index_count;
+	uint32_t first_index;
+	int32_t vertex_offset;
+	uint32_t instance_count;
+	uint32_t first_instance;
+} spel_gfx_draw_indexed_instanced_cmd;
+
+// both indirect draws, the type says which argument layout `buf` holds
+typedef struct spel_gfx_draw_indirect_cmd
+{
+	spel_gfx_cmd_header hdr;
+	uint64_t sort_key;
+	spel_gfx_buffer buf;
+	size_t offset;
+	uint32_t draw_count;
+	uint32_t stride;
+} spel_gfx_draw_indirect_cmd;
+
+typedef struct spel_gfx_dispatch_cmd
+{
+	spel_gfx_cmd_header hdr;
+	uint32_t groups_x;
+	uint32_t groups_y;
+	uint32_t groups_z;
+} spel_gfx_dispatch_cmd;
+
+typedef struct spel_gfx_dispatch_indirect_cmd
+{
+	spel_gfx_cmd_header hdr;
+	spel_gfx_buffer buf;
+	size_t offset;
+} spel_gfx_dispatch_indirect_cmd;
+
+typedef struct spel_gfx_barrier_cmd
+{
+	spel_gfx_cmd_header hdr;
+	spel_gfx_barrier barriers;
+} spel_gfx_barrier_cmd;
+
 typedef struct spel_gfx_bind_texture_cmd
 {
 	spel_gfx_cmd_header hdr;
@@ -119,6 +184,8 @@ typedef struct spel_gfx_bind_shader_buffer_cmd
 	spel_gfx_cmd_header hdr;
 	spel_gfx_buffer buf;
 	uint32_t location;
+	size_t offset;
+	size_t size; // 0 binds the whole buffer
 } spel_gfx_bind_shader_buffer_cmd;
 
 typedef struct spel_gfx_buffer_update_cmd
@@ -150,4 +217,10 @@ typedef struct spel_gfx_end_render_pass_cmd
 	spel_gfx_cmd_header hdr;
 } spel_gfx_end_render_pass_cmd;
 
+typedef struct spel_gfx_execute_cmd
+{
+	spel_gfx_cmd_header hdr;
+	spel_gfx_cmdlist list;
+} spel_gfx_execute_cmd;
+
 #endif
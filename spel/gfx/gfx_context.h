@@ -8,6 +8,8 @@ typedef struct
 	spel_gfx_backend backend;
 	bool debug;
 	int vsync;
+	const char* program_cache_dir; // where linked programs get cached, null for none
+	bool shader_hot_reload;		   // reload spel_gfx_shader_load files when they change
 } spel_gfx_context_desc;
 
 spel_api spel_gfx_context spel_gfx_context_create(spel_gfx_context_desc* desc);
@@ -20,4 +22,7 @@ spel_api void* spel_gfx_context_internal_handle(spel_gfx_context ctx);
 spel_api void spel_gfx_frame_begin(spel_gfx_context ctx);
 spel_api void spel_gfx_frame_present(spel_gfx_context ctx);
 
+// counters for the last finished frame
+spel_api spel_gfx_frame_stats spel_gfx_frame_stats_get(spel_gfx_context ctx);
+
 #endif
\ No newline at end of file
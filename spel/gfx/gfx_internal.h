@@ -10,25 +10,104 @@
 #include "gfx_texture.h"
 #include "gfx_types.h"
 #include "gfx_uniform.h"
+#include <stdatomic.h>
 #include <stddef.h>
 #include <stdint.h>
 
 // command lists
+#define SPEL_GFX_CMDLIST_TRACKED_STREAMS 8
+#define SPEL_GFX_CMDLIST_TRACKED_SLOTS 16
+#define SPEL_GFX_CMDLIST_TRACKED_BUFFERS 8
+
+// what the recorder last wrote into the list. lets the cmd functions drop binds
+// that wouldn't change anything before they take up space in the buffer
+typedef struct spel_gfx_cmdlist_state
+{
+	spel_gfx_pipeline pipeline;
+
+	struct
+	{
+		spel_gfx_buffer buf;
+		size_t offset;
+	} vertex[SPEL_GFX_CMDLIST_TRACKED_STREAMS];
+
+	struct
+	{
+		spel_gfx_buffer buf;
+		size_t offset;
+		spel_gfx_index_type type;
+	} index;
+
+	spel_gfx_texture textures[SPEL_GFX_CMDLIST_TRACKED_SLOTS];
+	spel_gfx_sampler samplers[SPEL_GFX_CMDLIST_TRACKED_SLOTS];
+
+	struct
+	{
+		spel_gfx_buffer buf;
+		uint32_t location;
+		size_t offset;
+		size_t size;
+	} shader_buffers[SPEL_GFX_CMDLIST_TRACKED_BUFFERS];
+	uint32_t shader_buffer_count;
+
+	// sort key inputs and pass tracking, none of it is a bind
+	uint32_t pass_index;
+	float sort_depth;
+	bool in_pass;	 // a pass was begun and not ended yet
+	bool opens_pass; // the list begins a pass of its own somewhere
+
+	uint32_t epoch; // the context's resource_epoch the binds above were made under
+} spel_gfx_cmdlist_state;
+
+// commands are recorded into fixed-size chunks the backend recycles through a
+// pool, so appending never copies what's already there. a command never spans two
+// chunks; one that doesn't fit in a chunk gets a dedicated large chunk, which the
+// list keeps around for the next frame
+typedef struct spel_gfx_cmd_chunk
+{
+	struct spel_gfx_cmd_chunk* next;
+	uint32_t used;
+	uint32_t capacity;
+	bool large;
+} spel_gfx_cmd_chunk;
+
+#define spel_cmdlist_chunk_size (16 * 1024) // 16 KB, header included
+#define spel_cmdlist_chunk_header                                                          \
+	((sizeof(spel_gfx_cmd_chunk) + _Alignof(max_align_t) - 1) &                            \
+	 ~(_Alignof(max_align_t) - 1))
+
+static inline uint8_t* spel_gfx_cmd_chunk_data(spel_gfx_cmd_chunk* chunk)
+{
+	return (uint8_t*)chunk + spel_cmdlist_chunk_header;
+}
+
 typedef struct spel_gfx_cmdlist_t
 {
-	uint8_t* buffer;
-	uint64_t offset;
-	uint64_t capacity;
+	spel_gfx_cmd_chunk* head;
+	spel_gfx_cmd_chunk* tail;
+	spel_gfx_cmd_chunk* spare_large;
+	uint64_t offset; // bytes recorded since the last submit
+	uint32_t chunk_count;
+	uint32_t chunk_peak;
 
 	spel_gfx_context ctx;
 	void* data;
 
+	bool sorted;
+	bool secondary;
+	bool bundle; // a secondary that keeps its commands after replay
+	spel_gfx_cmdlist_state state;
+
+	// secondaries executed into this list, emptied once it's submitted
+	spel_gfx_cmdlist* secondaries;
+	uint32_t secondary_count;
+	uint32_t secondary_cap;
+
 	spel_gfx_buffer* dirty_buffers;
 	uint32_t dirty_buffer_count;
 	uint32_t dirty_buffer_cap;
 } spel_gfx_cmdlist_t;
 
-#define spel_cmdlist_default_size (4 * 1024) // 4 KB
 
 // buffers
 typedef struct spel_gfx_buffer_t
@@ -42,6 +121,32 @@ typedef struct spel_gfx_buffer_t
 	size_t size;
 } spel_gfx_buffer_t;
 
+// rings. every region is reused once the frame fence of its slot signals
+#define SPEL_GFX_FRAMES_IN_FLIGHT 3
+#define SPEL_GFX_RING_ALIGN 256
+#define SPEL_GFX_UNIFORM_RING_SIZE (64 * 1024)
+
+typedef struct spel_gfx_ring_retired
+{
+	spel_gfx_buffer buffer;
+	uint32_t slot; // frame slot that last wrote it
+	struct spel_gfx_ring_retired* next;
+} spel_gfx_ring_retired;
+
+typedef struct spel_gfx_ring_t
+{
+	spel_gfx_context ctx;
+	spel_gfx_buffer_type type;
+	spel_gfx_buffer buffer;
+	uint8_t* mapped;
+	size_t region_size;
+	size_t head; // bytes taken from the current frame's region
+
+	// outgrown buffers, kept until the frames that used them are done
+	spel_gfx_ring_retired* retired;
+	struct spel_gfx_ring_t* next;
+} spel_gfx_ring_t;
+
 // shaders
 typedef struct spel_gfx_shader_uniform
 {
@@ -65,11 +170,13 @@ typedef struct spel_gfx_shader_uniform
 	uint32_t array_count;
 
 	uint32_t internal;
+	uint64_t name_hash;
 } spel_gfx_shader_uniform;
 
 typedef struct spel_gfx_shader_block
 {
 	char* name;
+	uint64_t name_hash;
 	union
 	{
 		uint32_t location;
@@ -90,6 +197,13 @@ typedef struct spel_gfx_shader_block
 	uint32_t member_count;
 } spel_gfx_shader_block;
 
+typedef struct
+{
+	char* name;
+	uint32_t id;
+	uint32_t value; // the default, or what the desc overrode it with
+} spel_gfx_shader_spec_constant;
+
 typedef struct spel_gfx_shader_reflection
 {
 	spel_gfx_shader_block* uniforms;
@@ -100,6 +214,9 @@ typedef struct spel_gfx_shader_reflection
 
 	spel_gfx_shader_uniform* samplers;
 	uint32_t sampler_count;
+
+	spel_gfx_shader_spec_constant* constants;
+	uint32_t constant_count;
 } spel_gfx_shader_reflection;
 
 typedef struct spel_gfx_shader_t
@@ -117,9 +234,27 @@ typedef struct spel_gfx_shader_t
 typedef enum
 {
 	SPEL_GFX_PIPELINE_GRAPHIC,
-	SPEL_GFX_PIPELINE_COMPUTE // NOT supported yet lol
+	SPEL_GFX_PIPELINE_COMPUTE
 } spel_gfx_pipeline_type;
 
+#define SPEL_GFX_REFLECT_BLOCK UINT16_MAX
+
+// one entry of a pipeline lookup table, pointing into its merged reflection
+typedef struct
+{
+	uint64_t key; // name hash, or a block's location
+	uint16_t block;
+	uint16_t member; // SPEL_GFX_REFLECT_BLOCK when it's the block itself
+	bool storage;
+	bool used;
+} spel_gfx_reflection_slot;
+
+typedef struct
+{
+	spel_gfx_reflection_slot* slots;
+	uint32_t capacity;
+} spel_gfx_reflection_table;
+
 typedef struct spel_gfx_pipeline_t
 {
 	spel_gfx_context ctx;
@@ -128,9 +263,21 @@ typedef struct spel_gfx_pipeline_t
 	spel_gfx_shader vertex_shader;
 	spel_gfx_shader fragment_shader;
 	spel_gfx_shader geometry_shader;
+	spel_gfx_shader compute_shader;
 
 	spel_gfx_shader_reflection reflection;
+
+	// built with the merged reflection, so binds and name lookups never scan or
+	// compare strings
+	struct
+	{
+		spel_gfx_reflection_table blocks;
+		spel_gfx_reflection_table members;
+		spel_gfx_reflection_table locations;
+	} lookup;
+
 	uint64_t hash;
+	bool blended;
 
 	void* data;
 } spel_gfx_pipeline_t;
@@ -153,6 +300,7 @@ typedef struct
 	uint64_t hash;
 	uint32_t handle;
 	uint32_t ref_count;
+	bool pending; // linked in the background, status not checked yet
 } spel_gfx_program_cache_entry;
 
 typedef struct
@@ -185,6 +333,7 @@ typedef struct spel_gfx_texture_t
 	spel_gfx_texture_type type;
 	spel_gfx_texture_format format;
 	bool internal;
+	bool loading; // still a checkerboard view, an async load lands on it later
 	uint16_t width;
 	uint16_t height;
 	uint16_t depth;
@@ -229,6 +378,10 @@ typedef struct spel_gfx_render_pass_t
 
 // initialization
 typedef struct spel_gfx_vtable_t* spel_gfx_vtable;
+typedef struct spel_gfx_shader_watch_t* spel_gfx_shader_watch;
+typedef struct spel_gfx_texture_loader_t* spel_gfx_texture_loader;
+
+#define SPEL_GFX_TEXTURE_LOAD_BUDGET_NS (2 * 1000 * 1000)
 
 typedef struct spel_gfx_context_t
 {
@@ -255,7 +408,7 @@ typedef struct spel_gfx_context_t
 	spel_gfx_cmdlist cmdlist;
 	spel_gfx_pipeline_cache pipeline_cache;
 	spel_gfx_sampler_cache sampler_cache;
-	spel_gfx_shader shaders[5];
+	spel_gfx_shader shaders[8]; // 4 and up are the text variants, one per font mode
 
 	spel_gfx_sampler default_sampler;
 	spel_gfx_texture white_tex;
@@ -263,10 +416,29 @@ typedef struct spel_gfx_context_t
 
 	spel_gfx_render_pass default_pass;
 
+	spel_gfx_frame_stats stats;		 // filled in by the backend during the frame
+	spel_gfx_frame_stats last_stats; // what spel_gfx_frame_stats_get hands out
+
+	spel_gfx_ring rings;
+	spel_gfx_ring uniform_ring; // backs spel_gfx_uniform_alloc, made on first use
+	uint32_t uniform_align;		// offset alignment ranges bound to a block need
+	void* frame_fences[SPEL_GFX_FRAMES_IN_FLIGHT];
+	uint32_t frame_slot;
+
 	void* data;
 
 	spel_gfx_program_cache program_cache;
+	char* program_cache_dir; // on-disk program binaries, null when off
 	spel_gfx_vao_cache vao_cache;
+
+	spel_gfx_shader_watch shader_watch; // null unless hot reload is on
+
+	spel_gfx_texture_loader texture_loader; // made on the first async load
+	uint64_t texture_load_budget_ns;		// upload time async loads get per frame
+
+	// bumped whenever a buffer, texture or pipeline goes away. their slots get
+	// reused, so a new object can come back at a pointer a list already tracks
+	_Atomic uint32_t resource_epoch;
 } spel_gfx_context_t;
 
 typedef struct spel_gfx_vtable_t
@@ -277,10 +449,15 @@ typedef struct spel_gfx_vtable_t
 	void (*frame_begin)(spel_gfx_context);
 	void (*frame_end)(spel_gfx_context);
 
+	void* (*fence_insert)(spel_gfx_context);
+	// frees the fence, true if it had to block on it
+	bool (*fence_wait)(spel_gfx_context, void*);
+
 	spel_gfx_cmdlist (*cmdlist_create)(spel_gfx_context);
 	void (*cmdlist_destroy)(spel_gfx_cmdlist);
 	void (*cmdlist_submit)(spel_gfx_cmdlist);
 	void* (*cmdlist_alloc)(spel_gfx_cmdlist, size_t, size_t);
+	void (*cmdlist_reset)(spel_gfx_cmdlist);
 
 	spel_gfx_buffer (*buffer_create)(spel_gfx_context, const spel_gfx_buffer_desc*);
 	void (*buffer_destroy)(spel_gfx_buffer);
@@ -294,12 +471,19 @@ typedef struct spel_gfx_vtable_t
 	void (*shader_destroy)(spel_gfx_shader);
 
 	spel_gfx_pipeline (*pipeline_create)(spel_gfx_context, const spel_gfx_pipeline_desc*);
+	spel_gfx_pipeline (*pipeline_precompile)(spel_gfx_context,
+											 const spel_gfx_pipeline_desc*);
+	bool (*pipeline_ready)(spel_gfx_pipeline);
+	// relinks after one of the pipeline's shaders changed, false keeps the old program
+	bool (*pipeline_reload)(spel_gfx_pipeline);
 	void (*pipeline_destroy)(spel_gfx_pipeline);
 
 	spel_gfx_texture (*texture_create)(spel_gfx_context, const spel_gfx_texture_desc*);
 	void (*texture_destroy)(spel_gfx_texture);
 	void (*texture_resize)(spel_gfx_texture, uint32_t, uint32_t);
 	void (*texture_update)(spel_gfx_texture, uint32_t, spel_rect, void*, size_t);
+	spel_gfx_texture (*texture_view)(spel_gfx_texture);
+	bool (*texture_replace)(spel_gfx_texture, const spel_gfx_texture_desc*);
 
 	spel_gfx_sampler (*sampler_create)(spel_gfx_context, const spel_gfx_sampler_desc*);
 	void (*sampler_destroy)(spel_gfx_sampler);
@@ -342,6 +526,33 @@ spel_hidden extern void spel_gfx_pipeline_merge_reflections(spel_gfx_pipeline pi
 
 spel_hidden extern void spel_gfx_shader_reflection_free(spel_gfx_shader shader);
 
+spel_hidden uint64_t spel_gfx_reflect_name_hash(const char* name);
+spel_hidden void spel_gfx_pipeline_reflection_free(spel_gfx_pipeline pipeline);
+
+spel_hidden const spel_gfx_reflection_slot*
+spel_gfx_reflection_find(const spel_gfx_reflection_table* table, uint64_t key);
+spel_hidden spel_gfx_shader_block*
+spel_gfx_reflection_block(spel_gfx_pipeline pipeline,
+						  const spel_gfx_reflection_slot* slot);
+
+// shader hot reload, see gfx_shader_watch.c
+spel_hidden void spel_gfx_shader_watch_init(spel_gfx_context ctx);
+spel_hidden void spel_gfx_shader_watch_shutdown(spel_gfx_context ctx);
+spel_hidden void spel_gfx_shader_watch_add(spel_gfx_shader shader, const char* path);
+spel_hidden void spel_gfx_shader_watch_remove(spel_gfx_shader shader);
+spel_hidden void spel_gfx_shader_watch_poll(spel_gfx_context ctx);
+spel_hidden bool spel_gfx_shader_reload(spel_gfx_shader shader, const char* path);
+
+spel_hidden uint8_t*
+spel_gfx_texture_decoded_desc(uint8_t* pixels, int w, int h, int comp,
+							  const spel_gfx_texture_load_desc* desc,
+							  spel_gfx_texture_desc* tex);
+
+// async texture loads, see gfx_texture_async.c
+spel_hidden void spel_gfx_texture_loader_poll(spel_gfx_context ctx);
+spel_hidden void spel_gfx_texture_loader_cancel(spel_gfx_texture texture);
+spel_hidden void spel_gfx_texture_loader_shutdown(spel_gfx_context ctx);
+
 spel_hidden void spel_canvas_ctx_destroy(spel_canvas_context* ctx);
 spel_hidden void spel_canvas_ctx_flush(spel_canvas_context* ctx);
 
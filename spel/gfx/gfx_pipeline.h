@@ -68,6 +68,10 @@ typedef struct spel_gfx_pipeline_desc
 	spel_gfx_shader fragment_shader;
 	spel_gfx_shader geometry_shader;
 
+	// set this (and nothing else) for a compute pipeline, the rest of the desc is
+	// ignored then
+	spel_gfx_shader compute_shader;
+
 	spel_gfx_vertex_layout vertex_layout;
 
 	spel_gfx_primitive_topology topology;
@@ -97,10 +101,25 @@ spel_api spel_gfx_pipeline_desc spel_gfx_pipeline_fullscreen(spel_gfx_context ct
 
 spel_api spel_gfx_pipeline_desc spel_gfx_pipeline_default_2d(spel_gfx_context ctx);
 
+spel_api spel_gfx_pipeline_desc spel_gfx_pipeline_compute(spel_gfx_shader compute);
+
 spel_api spel_gfx_pipeline spel_gfx_pipeline_create(spel_gfx_context ctx,
 												  const spel_gfx_pipeline_desc* desc);
 spel_api void spel_gfx_pipeline_destroy(spel_gfx_pipeline pipeline);
 
+// starts linking every desc without waiting on the driver. with
+// KHR_parallel_shader_compile the links run on driver threads, without it they
+// happen right here, which at least keeps them out of the first frame that needs
+// them. the pipelines go into the pipeline cache, so creating one of these descs
+// later hands it back straight away. `out` can be null, failed entries are null
+spel_api void spel_gfx_pipeline_precompile(spel_gfx_context ctx,
+										  const spel_gfx_pipeline_desc* descs,
+										  uint32_t count, spel_gfx_pipeline* out);
+
+// false while the driver is still linking it. binding one early is fine, it
+// just waits for the link
+spel_api bool spel_gfx_pipeline_ready(spel_gfx_pipeline pipeline);
+
 spel_api uint8_t spel_gfx_pipeline_texture_count(spel_gfx_pipeline pipeline);
 
 #define spel_gfx_invalid_uniform_handle ((spel_gfx_uniform_handle*){0})
@@ -4,6 +4,16 @@
 #include "gfx/gfx_types.h"
 #include <stddef.h>
 
+// overrides a specialization constant, matched by `name` when it's set and by
+// `id` (the shader's constant_id) otherwise. `value` is the raw 32 bits, bools
+// go in as 0/1 and floats by their bit pattern
+typedef struct
+{
+	const char* name;
+	uint32_t id;
+	uint32_t value;
+} spel_gfx_shader_constant;
+
 typedef struct spel_gfx_shader_desc
 {
 	spel_gfx_shader_source shader_source;
@@ -12,6 +22,11 @@ typedef struct spel_gfx_shader_desc
 	size_t source_size;
 
 	const char* debug_name;
+
+	// branches on these fold away when the driver compiles the shader, every
+	// set of values is its own shader (and its own program in the cache)
+	const spel_gfx_shader_constant* constants;
+	uint32_t constant_count;
 } spel_gfx_shader_desc;
 
 spel_api spel_gfx_shader spel_gfx_shader_create(spel_gfx_context ctx,
@@ -63,6 +63,22 @@ spel_api spel_gfx_texture spel_gfx_texture_load(spel_gfx_context ctx, const char
 spel_api spel_gfx_texture spel_gfx_texture_load_data(spel_gfx_context ctx, const char* data, size_t dataSize,
 												const spel_gfx_texture_load_desc* desc);
 
+// decodes on worker threads and uploads over the next frames, the texture is a
+// checkerboard (sizes included) until then. `data` is copied
+spel_api spel_gfx_texture
+spel_gfx_texture_load_async(spel_gfx_context ctx, const char* path,
+							const spel_gfx_texture_load_desc* desc);
+spel_api spel_gfx_texture
+spel_gfx_texture_load_data_async(spel_gfx_context ctx, const char* data, size_t dataSize,
+								 const spel_gfx_texture_load_desc* desc);
+
+// true while an async load hasn't landed on the texture yet
+spel_api bool spel_gfx_texture_loading(spel_gfx_texture texture);
+
+// how long finished async loads may spend uploading each frame, at least one
+// always goes through
+spel_api void spel_gfx_texture_load_budget(spel_gfx_context ctx, uint64_t budgetNs);
+
 spel_api spel_gfx_texture spel_gfx_texture_load_color(spel_gfx_context ctx,
 													  const char* path);
 spel_api spel_gfx_texture spel_gfx_texture_load_linear(spel_gfx_context ctx,
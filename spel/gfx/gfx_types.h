@@ -12,6 +12,7 @@ typedef struct spel_gfx_texture_t* spel_gfx_texture;
 typedef struct spel_gfx_sampler_t* spel_gfx_sampler;
 typedef struct spel_gfx_framebuffer_t* spel_gfx_framebuffer;
 typedef struct spel_gfx_render_pass_t* spel_gfx_render_pass;
+typedef struct spel_gfx_ring_t* spel_gfx_ring;
 
 typedef enum
 {
@@ -23,7 +24,8 @@ typedef enum
 	SPEL_GFX_BUFFER_VERTEX,
 	SPEL_GFX_BUFFER_INDEX,
 	SPEL_GFX_BUFFER_UNIFORM,
-	SPEL_GFX_BUFFER_STORAGE
+	SPEL_GFX_BUFFER_STORAGE,
+	SPEL_GFX_BUFFER_INDIRECT // draw arguments, see spel_gfx_draw_indirect_args
 } spel_gfx_buffer_type;
 
 typedef enum
@@ -38,6 +40,21 @@ typedef uint32_t spel_gfx_access;
 #define spel_gfx_access_read (1u << 0)
 #define spel_gfx_access_write (1u << 1)
 
+// what a barrier makes visible: shader writes before it become readable through
+// the given paths after it
+typedef uint32_t spel_gfx_barrier;
+
+#define spel_gfx_barrier_vertex (1u << 0)
+#define spel_gfx_barrier_index (1u << 1)
+#define spel_gfx_barrier_uniform (1u << 2)
+#define spel_gfx_barrier_storage (1u << 3)
+#define spel_gfx_barrier_texture (1u << 4) // sampled reads
+#define spel_gfx_barrier_image (1u << 5)   // image load/store
+#define spel_gfx_barrier_indirect (1u << 6)
+#define spel_gfx_barrier_buffer_update (1u << 7)
+#define spel_gfx_barrier_framebuffer (1u << 8)
+#define spel_gfx_barrier_all (0xFFFFFFFFu)
+
 #define spel_gfx_access_invalidate_range (1u << 2)
 #define spel_gfx_access_invalidate_buffer (1u << 3)
 #define spel_gfx_access_unsynchronized (1u << 4)
@@ -309,4 +326,12 @@ typedef struct
 	unsigned int id;
 } spel_gfx_backend_msg;
 
+typedef struct
+{
+	uint32_t pipeline_binds;	  // pipeline binds that reached the backend
+	uint32_t state_calls;		  // render state calls those binds issued
+	uint32_t state_calls_skipped; // calls dropped because the state already matched
+	uint32_t fence_stalls; // times the cpu waited on the gpu to hand out ring space
+} spel_gfx_frame_stats;
+
 #endif
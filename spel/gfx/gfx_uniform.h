@@ -1,6 +1,7 @@
 #ifndef SPEL_GFX_UNIFORM
 #define SPEL_GFX_UNIFORM
 #include "core/macros.h"
+#include "gfx/gfx_buffer.h"
 #include "gfx/gfx_types.h"
 #include <stdint.h>
 
@@ -52,8 +53,21 @@ spel_api char** spel_gfx_uniform_block_names(spel_gfx_pipeline pipeline,
 spel_api spel_gfx_uniform_buffer spel_gfx_uniform_buffer_create(spel_gfx_pipeline pipeline,
 															  const char* blockName);
 
+// location and size of a block without a buffer behind it, for pushes
+spel_api spel_gfx_uniform_buffer spel_gfx_uniform_block_get(spel_gfx_pipeline pipeline,
+														  const char* blockName);
+
 spel_api void spel_gfx_uniform_buffer_destroy(spel_gfx_uniform_buffer buf);
 
+// per-frame linear allocator for uniform data. slices come out of one big ubo,
+// aligned so any of them can be bound with spel_gfx_cmd_bind_shader_buffer_offset,
+// and are only good for the frame they were taken in. allocate at least the
+// block's size for each one you bind
+spel_api spel_gfx_ring_slice spel_gfx_uniform_alloc(spel_gfx_context ctx, size_t size);
+
+// offsets handed to an offset bind have to be a multiple of this
+spel_api uint32_t spel_gfx_uniform_alignment(spel_gfx_context ctx);
+
 spel_api uint32_t spel_gfx_uniform_block_size(spel_gfx_pipeline pipeline,
 											spel_gfx_uniform handle);
 
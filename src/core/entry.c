@@ -58,6 +58,7 @@ spel_api void spel_run()
 
 spel_hidden void spel_run_frame()
 {
+	spel_memory_frame_reset();
 	spel_time_frame_begin(&spel.time);
 	spel_input_update();
 	spel_event_poll();
@@ -104,6 +105,7 @@ spel_api int spel_app_run(spel_app_desc* app)
 	}
 
 	spel_memory_sdl_setup();
+	spel_memory_frame_init();
 
 	spel_runtime_info_setup();
 	spel_build_info_init();
@@ -120,6 +122,11 @@ spel_api int spel_app_run(spel_app_desc* app)
 		spel.env.debug = true;
 	}
 
+	if (spel_args_has("--alloc-profile"))
+	{
+		spel_memory_profile_start(64);
+	}
+
 	spel_callback(spel.app.conf);
 
 	SDL_SetHint(SDL_HINT_JOYSTICK_LINUX_DEADZONES, "1");
@@ -140,6 +147,8 @@ spel_api int spel_app_run(spel_app_desc* app)
 	gfx_desc.backend = spel.app.gfx_backend;
 	gfx_desc.vsync = spel.window.swapchain.vsync;
 	gfx_desc.debug = spel.env.debug;
+	gfx_desc.program_cache_dir = spel.app.program_cache_dir;
+	gfx_desc.shader_hot_reload = spel.app.shader_hot_reload;
 
 	spel.gfx = spel_gfx_context_create(&gfx_desc);
 
@@ -153,6 +162,14 @@ spel_api int spel_app_run(spel_app_desc* app)
 	spel_gfx_context_destroy(spel.gfx);
 	spel_window_cleanup();
 	spel_event_terminate();
+	spel_memory_frame_shutdown();
+
+	if (spel_args_has("--alloc-profile"))
+	{
+		spel_memory_profile_stop();
+		spel_memory_profile_dump("spel-alloc.folded");
+		spel_memory_profile_shutdown();
+	}
 
 	return 0;
 }
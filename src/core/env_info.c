@@ -294,7 +294,7 @@ spel_hidden void spel_runtime_info_setup()
 	spel_env_info_fill(&spel.env);
 	spel_process_info_fill(&spel.process);
 
-	spel.hardware.cpu_model = spel_memory_malloc(128, SPEL_MEM_TAG_CORE);
+	spel.hardware.cpu_model = spel_memory_calloc(1, 128, SPEL_MEM_TAG_CORE);
 	spel.hardware.cpu_cores = spel_physical_cores_detect();
 	read_cpu_model(spel.hardware.cpu_model, 128);
 
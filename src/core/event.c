@@ -27,8 +27,8 @@ static uint64_t hash_str(const char* s)
 static void intern_grow(struct spel_event_intern_table* interns)
 {
 	size_t new_cap = interns->capacity ? interns->capacity * 2 : 16;
-	struct spel_event_intern_entry* new_entries = spel_memory_malloc(
-		new_cap * sizeof(struct spel_event_intern_entry), SPEL_MEM_TAG_CORE);
+	struct spel_event_intern_entry* new_entries = spel_memory_calloc(
+		new_cap, sizeof(struct spel_event_intern_entry), SPEL_MEM_TAG_CORE);
 
 	for (size_t i = 0; i < interns->capacity; ++i)
 	{
@@ -90,7 +90,7 @@ static void event_table_grow(spel_events* events)
 {
 	size_t new_cap = events->capacity ? events->capacity * 2 : 16;
 	struct spel_event_bucket* new_buckets =
-		spel_memory_malloc(new_cap * sizeof(struct spel_event_bucket), SPEL_MEM_TAG_CORE);
+		spel_memory_calloc(new_cap, sizeof(struct spel_event_bucket), SPEL_MEM_TAG_CORE);
 
 	for (size_t i = 0; i < events->capacity; ++i)
 	{
@@ -66,7 +66,14 @@ spel_api spel_log_event spel_log_fmt(spel_log_event evt, const char* fmt, ...)
 	if (orig_len)
 		total_len += orig_len + 3;
 
-	char* heap_buf = spel_memory_malloc(total_len + 1, SPEL_MEM_TAG_CORE);
+	// the frame arena owns the buffer when we can get one, nothing to free later
+	char* heap_buf = spel_memory_frame_alloc(total_len + 1);
+	bool owned = heap_buf == NULL;
+	if (owned)
+	{
+		heap_buf = spel_memory_malloc(total_len + 1, SPEL_MEM_TAG_CORE);
+	}
+
 	if (!heap_buf)
 	{
 		va_end(args);
@@ -99,7 +106,7 @@ spel_api spel_log_event spel_log_fmt(spel_log_event evt, const char* fmt, ...)
 
 	evt->message = heap_buf;
 	evt->length = (uint32_t)total_len;
-	evt->message_owned = true;
+	evt->message_owned = owned;
 
 	va_end(args);
 	va_end(args_copy);
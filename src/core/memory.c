@@ -1,20 +1,142 @@
 #include "core/memory.h"
 #include "SDL3/SDL_stdinc.h"
+#include "SDL3/SDL_thread.h"
 #include "core/log.h"
 #include "core/types.h"
 #include "utils/terminal.h"
 #include <limits.h>
 #include <signal.h>
+#include <stdatomic.h>
 #include <stdio.h>
 #include <string.h>
 
+#ifndef SPEL_MEMORY_THIN
 typedef struct spel_alloc_header
 {
 	uint32_t magic;
 	size_t size;
 	spel_memory_tag tag;
 } spel_alloc_header;
+#endif
 
+// each thread only ever writes its own shard, so plain relaxed load/store pairs
+// are enough and the hot path never takes a lock or a locked rmw. readers merge
+// every shard on demand
+typedef struct spel_memory_shard_tag
+{
+	_Atomic uint64_t allocated;
+	_Atomic uint64_t freed;
+	_Atomic uint64_t peak;
+	_Atomic uint64_t alloc_count;
+	_Atomic uint64_t free_count;
+	_Atomic uint64_t largest_block;
+} spel_memory_shard_tag;
+
+typedef struct spel_memory_shard
+{
+	_Atomic uint64_t allocated;
+	_Atomic uint64_t freed;
+	_Atomic uint64_t peak;
+	_Atomic uint64_t header_allocated;
+	_Atomic uint64_t header_freed;
+	_Atomic uint64_t alloc_count;
+	_Atomic uint64_t free_count;
+
+	spel_memory_shard_tag tags[SPEL_MEM_TAG_COUNT];
+
+	struct spel_memory_shard* next;
+} spel_memory_shard;
+
+extern _Atomic bool spel_memory_profiling;
+
+static _Atomic(spel_memory_shard*) spel_memory_shards = NULL;
+static _Atomic uint64_t spel_memory_peak_seen = 0;
+static spel_thread_local spel_memory_shard* spel_memory_local_shard = NULL;
+
+static inline uint64_t spel_shard_load(_Atomic uint64_t* counter)
+{
+	return atomic_load_explicit(counter, memory_order_relaxed);
+}
+
+static inline void spel_shard_add(_Atomic uint64_t* counter, uint64_t value)
+{
+	atomic_store_explicit(counter, spel_shard_load(counter) + value,
+						  memory_order_relaxed);
+}
+
+static inline void spel_shard_max(_Atomic uint64_t* counter, uint64_t value)
+{
+	if (value > spel_shard_load(counter))
+	{
+		atomic_store_explicit(counter, value, memory_order_relaxed);
+	}
+}
+
+static spel_memory_shard* spel_memory_shard_get()
+{
+	spel_memory_shard* shard = spel_memory_local_shard;
+	if (shard)
+	{
+		return shard;
+	}
+
+	// shards are never freed, memory allocated on a dead thread can still be
+	// released somewhere else and the numbers have to add up
+	shard = calloc(1, sizeof(*shard));
+	if (!shard)
+	{
+		return NULL;
+	}
+
+	spel_memory_shard* head = atomic_load_explicit(&spel_memory_shards, memory_order_relaxed);
+	do
+	{
+		shard->next = head;
+	} while (!atomic_compare_exchange_weak_explicit(&spel_memory_shards, &head, shard,
+													memory_order_release,
+													memory_order_relaxed));
+
+	spel_memory_local_shard = shard;
+	return shard;
+}
+
+// net bytes can go negative on a shard that frees what another thread allocated
+static inline uint64_t spel_shard_net(uint64_t allocated, uint64_t freed)
+{
+	return allocated > freed ? allocated - freed : 0;
+}
+
+static void spel_memory_track_grow(spel_memory_tag tag, size_t delta)
+{
+	spel_memory_shard* shard = spel_memory_shard_get();
+	if (!shard)
+	{
+		return;
+	}
+
+	spel_shard_add(&shard->allocated, delta);
+	spel_shard_max(&shard->peak, spel_shard_net(spel_shard_load(&shard->allocated),
+												spel_shard_load(&shard->freed)));
+
+	spel_memory_shard_tag* ts = &shard->tags[tag];
+	spel_shard_add(&ts->allocated, delta);
+	spel_shard_max(&ts->peak, spel_shard_net(spel_shard_load(&ts->allocated),
+											 spel_shard_load(&ts->freed)));
+}
+
+static void spel_memory_track_shrink(spel_memory_tag tag, size_t delta)
+{
+	spel_memory_shard* shard = spel_memory_shard_get();
+	if (!shard)
+	{
+		return;
+	}
+
+	spel_shard_add(&shard->freed, delta);
+	spel_shard_add(&shard->tags[tag].freed, delta);
+}
+
+#ifndef SPEL_MEMORY_THIN
 spel_api void* spel_memory_malloc(size_t size, spel_memory_tag tag)
 {
 	if ((int)tag < 0 || tag >= SPEL_MEM_TAG_COUNT)
@@ -42,28 +164,20 @@ spel_api void* spel_memory_malloc(size_t size, spel_memory_tag tag)
 	h->size = size;
 	h->tag = tag;
 
-	spel.memory.current += size;
-	spel.memory.total_allocated += size;
-	spel.memory.header_allocated += sizeof(spel_alloc_header);
-	spel.memory.alloc_count++;
-
-	if (spel.memory.current > spel.memory.peak)
-	{
-		spel.memory.peak = spel.memory.current;
-	}
-
-	spel_memory_tag_stats* ts = &spel.memory.tags[tag];
-	ts->bytes_current += size;
-	ts->alloc_count++;
+	spel_memory_track_grow(tag, size);
 
-	if (size > ts->largest_block)
+	spel_memory_shard* shard = spel_memory_local_shard;
+	if (shard)
 	{
-		ts->largest_block = size;
+		spel_shard_add(&shard->header_allocated, sizeof(spel_alloc_header));
+		spel_shard_add(&shard->alloc_count, 1);
+		spel_shard_add(&shard->tags[tag].alloc_count, 1);
+		spel_shard_max(&shard->tags[tag].largest_block, size);
 	}
 
-	if (ts->bytes_current > ts->bytes_peak)
+	if (atomic_load_explicit(&spel_memory_profiling, memory_order_acquire))
 	{
-		ts->bytes_peak = ts->bytes_current;
+		spel_memory_profile_record(size);
 	}
 
 	return (void*)(h + 1);
@@ -93,13 +207,15 @@ spel_api void spel_memory_free(void* ptr)
 		return;
 	}
 
-	spel.memory.current -= size;
-	spel.memory.total_freed += size;
-	spel.memory.free_count++;
-	spel.memory.header_freed += sizeof(spel_alloc_header);
+	spel_memory_track_shrink(tag, size);
 
-	spel.memory.tags[tag].bytes_current -= size;
-	spel.memory.tags[tag].free_count++;
+	spel_memory_shard* shard = spel_memory_local_shard;
+	if (shard)
+	{
+		spel_shard_add(&shard->header_freed, sizeof(spel_alloc_header));
+		spel_shard_add(&shard->free_count, 1);
+		spel_shard_add(&shard->tags[tag].free_count, 1);
+	}
 
 	free(h);
 
@@ -156,44 +272,115 @@ spel_api void* spel_memory_realloc(void* ptr, size_t newSize, spel_memory_tag ta
 
 	if (newSize > old_size)
 	{
-		size_t delta = newSize - old_size;
+		spel_memory_track_grow(use_tag, newSize - old_size);
+	}
+	else if (newSize < old_size)
+	{
+		spel_memory_track_shrink(use_tag, old_size - newSize);
+	}
 
-		spel.memory.current += delta;
-		spel.memory.total_allocated += delta;
+	if (spel_memory_local_shard)
+	{
+		spel_shard_max(&spel_memory_local_shard->tags[use_tag].largest_block, newSize);
+	}
 
-		if (spel.memory.current > spel.memory.peak)
-		{
-			spel.memory.peak = spel.memory.current;
-		}
+	new_h->size = newSize;
+	new_h->tag = use_tag;
 
-		spel.memory.tags[use_tag].bytes_current += delta;
-		if (spel.memory.tags[use_tag].bytes_current >
-			spel.memory.tags[use_tag].bytes_peak)
-		{
-			spel.memory.tags[use_tag].bytes_peak =
-				spel.memory.tags[use_tag].bytes_current;
-		}
+	return (void*)(new_h + 1);
+}
+
+spel_api void* spel_memory_calloc(size_t count, size_t size, spel_memory_tag tag)
+{
+	if (count && size > SIZE_MAX / count)
+	{
+		return NULL;
 	}
-	else if (newSize < old_size)
+
+	// tracked blocks are always zeroed
+	return spel_memory_malloc(count * size, tag);
+}
+#else
+// thin allocator: straight to the libc size classes, no header, no memset and
+// no magic checks. tags only survive as sampled allocation stats
+#	ifndef SPEL_MEMORY_SAMPLE_RATE
+#		define SPEL_MEMORY_SAMPLE_RATE 0
+#	endif
+
+#	if SPEL_MEMORY_SAMPLE_RATE > 0
+static spel_thread_local uint32_t spel_memory_sample_tick = 0;
+#	endif
+
+static inline void spel_memory_sample(size_t size, spel_memory_tag tag)
+{
+#	if SPEL_MEMORY_SAMPLE_RATE > 0
+	if (++spel_memory_sample_tick < SPEL_MEMORY_SAMPLE_RATE)
+	{
+		return;
+	}
+	spel_memory_sample_tick = 0;
+
+	if ((int)tag < 0 || tag >= SPEL_MEM_TAG_COUNT)
 	{
-		size_t delta = old_size - newSize;
+		return;
+	}
 
-		spel.memory.current -= delta;
-		spel.memory.total_freed += delta;
+	spel_memory_track_grow(tag, size * SPEL_MEMORY_SAMPLE_RATE);
 
-		spel.memory.tags[use_tag].bytes_current -= delta;
+	spel_memory_shard* shard = spel_memory_local_shard;
+	if (shard)
+	{
+		spel_shard_add(&shard->alloc_count, SPEL_MEMORY_SAMPLE_RATE);
+		spel_shard_add(&shard->tags[tag].alloc_count, SPEL_MEMORY_SAMPLE_RATE);
+		spel_shard_max(&shard->tags[tag].largest_block, size);
 	}
+#	else
+	spel_unused(size);
+	spel_unused(tag);
+#	endif
+}
 
-	if (newSize > spel.memory.tags[use_tag].largest_block)
+spel_api void* spel_memory_malloc(size_t size, spel_memory_tag tag)
+{
+	spel_memory_sample(size, tag);
+	if (atomic_load_explicit(&spel_memory_profiling, memory_order_acquire))
 	{
-		spel.memory.tags[use_tag].largest_block = newSize;
+		spel_memory_profile_record(size);
 	}
+	return malloc(size);
+}
 
-	new_h->size = newSize;
-	new_h->tag = use_tag;
+spel_api void* spel_memory_calloc(size_t count, size_t size, spel_memory_tag tag)
+{
+	spel_memory_sample(count * size, tag);
+	if (atomic_load_explicit(&spel_memory_profiling, memory_order_acquire))
+	{
+		spel_memory_profile_record(count * size);
+	}
+	return calloc(count, size);
+}
 
-	return (void*)(new_h + 1);
+spel_api void spel_memory_free(void* ptr)
+{
+	free(ptr);
+}
+
+spel_api void* spel_memory_realloc(void* ptr, size_t newSize, spel_memory_tag tag)
+{
+	if (!ptr)
+	{
+		return spel_memory_malloc(newSize, tag);
+	}
+
+	if (newSize == 0)
+	{
+		free(ptr);
+		return NULL;
+	}
+
+	return realloc(ptr, newSize);
 }
+#endif
 
 const spel_api char* spel_memory_fmt_size(size_t bytes, char buf[32], bool colors)
 {
@@ -220,6 +407,449 @@ const spel_api char* spel_memory_fmt_size(size_t bytes, char buf[32], bool color
 	return buf;
 }
 
+#define SPEL_FRAME_ARENA_DEFAULT (64 * 1024)
+#define SPEL_FRAME_ARENA_MAX (16 * 1024 * 1024)
+#define SPEL_FRAME_ARENA_ALIGN 16
+// spills this big are one-offs (decoded images and such), sizing the arena after
+// them would keep the memory around for good
+#define SPEL_FRAME_ARENA_LARGE (1024 * 1024)
+// frames in a row using under a quarter of the arena before it gets halved
+#define SPEL_FRAME_ARENA_DECAY_FRAMES 120
+
+typedef struct spel_frame_spill
+{
+	struct spel_frame_spill* next;
+	size_t size;
+	bool large; // doesn't count toward growing the arena
+} spel_frame_spill;
+
+static size_t spel_frame_spill_header()
+{
+	return (sizeof(spel_frame_spill) + SPEL_FRAME_ARENA_ALIGN - 1) &
+		   ~(size_t)(SPEL_FRAME_ARENA_ALIGN - 1);
+}
+
+spel_hidden void spel_memory_frame_init()
+{
+	spel_memory_arena* arena = &spel.memory.frame;
+	if (arena->base)
+	{
+		return;
+	}
+
+	arena->base = spel_memory_malloc(SPEL_FRAME_ARENA_DEFAULT, SPEL_MEM_TAG_TEMP);
+	arena->capacity = arena->base ? SPEL_FRAME_ARENA_DEFAULT : 0;
+	arena->offset = 0;
+	arena->owner = SDL_GetCurrentThreadID();
+}
+
+spel_api void* spel_memory_frame_alloc(size_t size)
+{
+	spel_memory_arena* arena = &spel.memory.frame;
+	if (!arena->base || arena->owner != SDL_GetCurrentThreadID())
+	{
+		return NULL;
+	}
+
+	uintptr_t start = (uintptr_t)arena->base + arena->offset;
+	size_t pad = (SPEL_FRAME_ARENA_ALIGN - (start & (SPEL_FRAME_ARENA_ALIGN - 1))) &
+				 (SPEL_FRAME_ARENA_ALIGN - 1);
+
+	if (size <= arena->capacity - arena->offset &&
+		pad <= arena->capacity - arena->offset - size)
+	{
+		void* ptr = arena->base + arena->offset + pad;
+		arena->offset += pad + size;
+
+		if (arena->offset > arena->peak)
+		{
+			arena->peak = arena->offset;
+		}
+		return ptr;
+	}
+
+	// out of room, spill to the heap and remember to grow on the next reset unless
+	// it's a large one
+	size_t header = spel_frame_spill_header();
+	if (size > SIZE_MAX - header)
+	{
+		return NULL;
+	}
+
+	spel_frame_spill* spill = spel_memory_malloc(header + size, SPEL_MEM_TAG_TEMP);
+	if (!spill)
+	{
+		return NULL;
+	}
+
+	spill->next = arena->spills;
+	spill->size = size;
+	spill->large = size >= SPEL_FRAME_ARENA_LARGE;
+	arena->spills = spill;
+	arena->spill_count++;
+	if (!spill->large)
+	{
+		arena->spill_bytes += size;
+	}
+
+	return (uint8_t*)spill + header;
+}
+
+spel_api bool spel_memory_frame_owns(const void* ptr)
+{
+	spel_memory_arena* arena = &spel.memory.frame;
+	if (!ptr || !arena->base)
+	{
+		return false;
+	}
+
+	const uint8_t* p = ptr;
+	if (p >= arena->base && p < arena->base + arena->capacity)
+	{
+		return true;
+	}
+
+	size_t header = spel_frame_spill_header();
+	for (spel_frame_spill* spill = arena->spills; spill; spill = spill->next)
+	{
+		if (p == (uint8_t*)spill + header)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+spel_api spel_memory_frame_marker spel_memory_frame_mark()
+{
+	return (spel_memory_frame_marker){.offset = spel.memory.frame.offset,
+									  .spill_count = spel.memory.frame.spill_count};
+}
+
+spel_api void spel_memory_frame_rewind(spel_memory_frame_marker marker)
+{
+	spel_memory_arena* arena = &spel.memory.frame;
+	if (!arena->base || arena->owner != SDL_GetCurrentThreadID())
+	{
+		return;
+	}
+
+	while (arena->spill_count > marker.spill_count && arena->spills)
+	{
+		spel_frame_spill* spill = arena->spills;
+		arena->spills = spill->next;
+		arena->spill_count--;
+		if (!spill->large)
+		{
+			arena->spill_bytes -= spill->size;
+		}
+		spel_memory_free(spill);
+	}
+
+	if (marker.offset < arena->offset)
+	{
+		arena->offset = marker.offset;
+	}
+}
+
+spel_hidden void spel_memory_frame_reset()
+{
+	spel_memory_arena* arena = &spel.memory.frame;
+	if (!arena->base)
+	{
+		return;
+	}
+
+	size_t needed = arena->offset + arena->spill_bytes;
+
+	while (arena->spills)
+	{
+		spel_frame_spill* spill = arena->spills;
+		arena->spills = spill->next;
+		spel_memory_free(spill);
+	}
+
+	arena->spill_count = 0;
+	arena->spill_bytes = 0;
+	arena->offset = 0;
+
+	// grow so the next frame like this one fits without spilling, and give it back
+	// once frames have stayed well under it for a while
+	size_t capacity = arena->capacity;
+	if (needed > arena->capacity && arena->capacity < SPEL_FRAME_ARENA_MAX)
+	{
+		while (capacity < needed && capacity < SPEL_FRAME_ARENA_MAX)
+		{
+			capacity *= 2;
+		}
+		arena->quiet_frames = 0;
+	}
+	else if (arena->capacity > SPEL_FRAME_ARENA_DEFAULT && needed <= arena->capacity / 4)
+	{
+		if (++arena->quiet_frames >= SPEL_FRAME_ARENA_DECAY_FRAMES)
+		{
+			capacity /= 2;
+			arena->quiet_frames = 0;
+		}
+	}
+	else
+	{
+		arena->quiet_frames = 0;
+	}
+
+	if (capacity != arena->capacity)
+	{
+		uint8_t* base = spel_memory_malloc(capacity, SPEL_MEM_TAG_TEMP);
+		if (base)
+		{
+			spel_memory_free(arena->base);
+			arena->base = base;
+			arena->capacity = capacity;
+		}
+	}
+
+	if (needed > arena->peak)
+	{
+		arena->peak = needed;
+	}
+}
+
+spel_hidden void spel_memory_frame_shutdown()
+{
+	spel_memory_frame_reset();
+	spel_memory_free(spel.memory.frame.base);
+
+	spel.memory.frame.base = NULL;
+	spel.memory.frame.capacity = 0;
+}
+
+#define SPEL_POOL_ALIGN 16
+
+typedef struct spel_pool_slab
+{
+	struct spel_pool_slab* next;
+} spel_pool_slab;
+
+static size_t spel_pool_slab_header()
+{
+	return (sizeof(spel_pool_slab) + SPEL_POOL_ALIGN - 1) & ~(size_t)(SPEL_POOL_ALIGN - 1);
+}
+
+spel_api void spel_memory_pool_init(spel_memory_pool* pool, const char* name,
+								  size_t slotSize, uint32_t slotsPerSlab,
+								  spel_memory_tag tag)
+{
+	if (slotSize < sizeof(void*))
+	{
+		slotSize = sizeof(void*);
+	}
+
+	pool->name = name;
+	pool->tag = tag;
+	pool->slot_size = (slotSize + SPEL_POOL_ALIGN - 1) & ~(size_t)(SPEL_POOL_ALIGN - 1);
+	pool->slots_per_slab = slotsPerSlab ? slotsPerSlab : 32;
+
+	pool->slabs = NULL;
+	pool->free_list = NULL;
+	pool->slab_count = 0;
+	pool->used = 0;
+	pool->peak = 0;
+
+	pool->next = spel.memory.pools;
+	spel.memory.pools = pool;
+}
+
+spel_api void spel_memory_pool_destroy(spel_memory_pool* pool)
+{
+	if (pool->used > 0)
+	{
+		spel_warn("pool %s destroyed with %u slots still alive", pool->name, pool->used);
+	}
+
+	spel_pool_slab* slab = pool->slabs;
+	while (slab)
+	{
+		spel_pool_slab* next = slab->next;
+		spel_memory_free(slab);
+		slab = next;
+	}
+
+	for (spel_memory_pool** it = &spel.memory.pools; *it; it = &(*it)->next)
+	{
+		if (*it == pool)
+		{
+			*it = pool->next;
+			break;
+		}
+	}
+
+	pool->slabs = NULL;
+	pool->free_list = NULL;
+	pool->slab_count = 0;
+	pool->used = 0;
+	pool->next = NULL;
+}
+
+static bool spel_memory_pool_grow(spel_memory_pool* pool)
+{
+	size_t header = spel_pool_slab_header();
+	spel_pool_slab* slab = spel_memory_malloc(
+		header + (pool->slot_size * pool->slots_per_slab), pool->tag);
+	if (!slab)
+	{
+		return false;
+	}
+
+	slab->next = pool->slabs;
+	pool->slabs = slab;
+	pool->slab_count++;
+
+	// thread back to front so slots come out in address order
+	uint8_t* slots = (uint8_t*)slab + header;
+	for (uint32_t i = pool->slots_per_slab; i-- > 0;)
+	{
+		void** slot = (void**)(slots + (i * pool->slot_size));
+		*slot = pool->free_list;
+		pool->free_list = slot;
+	}
+
+	return true;
+}
+
+spel_api void* spel_memory_pool_alloc(spel_memory_pool* pool)
+{
+	if (!pool->free_list && !spel_memory_pool_grow(pool))
+	{
+		spel_error(SPEL_ERR_OOM, "failed to grow pool %s", pool->name);
+		return NULL;
+	}
+
+	void** slot = pool->free_list;
+	pool->free_list = *slot;
+
+	pool->used++;
+	if (pool->used > pool->peak)
+	{
+		pool->peak = pool->used;
+	}
+
+	memset(slot, 0, pool->slot_size);
+	return slot;
+}
+
+spel_api void spel_memory_pool_free(spel_memory_pool* pool, void* ptr)
+{
+	if (!ptr)
+	{
+		return;
+	}
+
+#ifdef DEBUG
+	memset(ptr, 0xDD, pool->slot_size);
+#endif
+
+	*(void**)ptr = pool->free_list;
+	pool->free_list = ptr;
+	pool->used--;
+}
+
+spel_api spel_memory spel_memory_snapshot()
+{
+	spel_memory out = spel.memory;
+
+	uint64_t allocated = 0;
+	uint64_t freed = 0;
+	uint64_t peak = 0;
+	uint64_t header_allocated = 0;
+	uint64_t header_freed = 0;
+	uint64_t alloc_count = 0;
+	uint64_t free_count = 0;
+
+	uint64_t tag_allocated[SPEL_MEM_TAG_COUNT] = {0};
+	uint64_t tag_freed[SPEL_MEM_TAG_COUNT] = {0};
+	uint64_t tag_peak[SPEL_MEM_TAG_COUNT] = {0};
+	uint64_t tag_allocs[SPEL_MEM_TAG_COUNT] = {0};
+	uint64_t tag_frees[SPEL_MEM_TAG_COUNT] = {0};
+	uint64_t tag_largest[SPEL_MEM_TAG_COUNT] = {0};
+
+	for (spel_memory_shard* shard =
+			 atomic_load_explicit(&spel_memory_shards, memory_order_acquire);
+		 shard; shard = shard->next)
+	{
+		allocated += spel_shard_load(&shard->allocated);
+		freed += spel_shard_load(&shard->freed);
+		header_allocated += spel_shard_load(&shard->header_allocated);
+		header_freed += spel_shard_load(&shard->header_freed);
+		alloc_count += spel_shard_load(&shard->alloc_count);
+		free_count += spel_shard_load(&shard->free_count);
+
+		uint64_t shard_peak = spel_shard_load(&shard->peak);
+		peak = shard_peak > peak ? shard_peak : peak;
+
+		for (int i = 0; i < SPEL_MEM_TAG_COUNT; ++i)
+		{
+			spel_memory_shard_tag* ts = &shard->tags[i];
+			tag_allocated[i] += spel_shard_load(&ts->allocated);
+			tag_freed[i] += spel_shard_load(&ts->freed);
+			tag_allocs[i] += spel_shard_load(&ts->alloc_count);
+			tag_frees[i] += spel_shard_load(&ts->free_count);
+
+			uint64_t p = spel_shard_load(&ts->peak);
+			tag_peak[i] = p > tag_peak[i] ? p : tag_peak[i];
+
+			uint64_t largest = spel_shard_load(&ts->largest_block);
+			tag_largest[i] = largest > tag_largest[i] ? largest : tag_largest[i];
+		}
+	}
+
+	// peaks are per shard, so the merged one is a lower bound that only gets
+	// tighter every time somebody takes a snapshot
+	uint64_t current = spel_shard_net(allocated, freed);
+	peak = current > peak ? current : peak;
+
+	uint64_t seen = atomic_load_explicit(&spel_memory_peak_seen, memory_order_relaxed);
+	while (peak > seen && !atomic_compare_exchange_weak_explicit(
+							  &spel_memory_peak_seen, &seen, peak, memory_order_relaxed,
+							  memory_order_relaxed))
+	{
+	}
+	peak = seen > peak ? seen : peak;
+
+#ifdef SPEL_MEMORY_THIN
+	// frees are never sampled, so anything net would just be the running total
+	current = 0;
+	peak = 0;
+#endif
+
+	out.current = current;
+	out.peak = peak;
+	out.total_allocated = allocated;
+	out.total_freed = freed;
+	out.header_allocated = header_allocated;
+	out.header_freed = header_freed;
+	out.alloc_count = alloc_count;
+	out.free_count = free_count;
+
+	for (int i = 0; i < SPEL_MEM_TAG_COUNT; ++i)
+	{
+		spel_memory_tag_stats* ts = &out.tags[i];
+		ts->bytes_total = tag_allocated[i];
+#ifndef SPEL_MEMORY_THIN
+		ts->bytes_current = spel_shard_net(tag_allocated[i], tag_freed[i]);
+		ts->bytes_peak = tag_peak[i] > ts->bytes_current ? tag_peak[i] : ts->bytes_current;
+#else
+		ts->bytes_current = 0;
+		ts->bytes_peak = 0;
+#endif
+		ts->alloc_count = tag_allocs[i];
+		ts->free_count = tag_frees[i];
+		ts->largest_block = tag_largest[i];
+	}
+
+	return out;
+}
+
 char* spel_mem_tag_names[SPEL_MEM_TAG_COUNT] = {
 	[SPEL_MEM_TAG_CORE] = "core",
 	[SPEL_MEM_TAG_GFX] = "gfx",
@@ -229,40 +859,77 @@ char* spel_mem_tag_names[SPEL_MEM_TAG_COUNT] = {
 
 spel_api void spel_memory_dump_terminal()
 {
-	char cur[32];
 	char peak[32];
 	char total[32];
-	char freed[32];
+
+	spel_memory mem = spel_memory_snapshot();
 
 	printf("%s%s==== spël memory dump ====%s\n", spel_terminal_bright_green,
 		   spel_terminal_bold, spel_terminal_reset);
 
+#ifdef SPEL_MEMORY_THIN
+	// frees aren't seen, so there is no current, peak or live count to show
+	printf("%s%sthin allocator, only sampled allocations are counted (1 in %d)%s\n",
+		   spel_terminal_italic, spel_terminal_gray, SPEL_MEMORY_SAMPLE_RATE,
+		   spel_terminal_reset);
+
+	printf("global:\n");
+	printf("    %stotal%s:    %s\n", spel_terminal_bright_blue, spel_terminal_reset,
+		   spel_memory_fmt_size(mem.total_allocated, total, true));
+	printf("    %sallocs%s:   %s%zu%s\n", spel_terminal_bright_blue, spel_terminal_reset,
+		   spel_terminal_bright_green, mem.alloc_count, spel_terminal_reset);
+
+	printf("\nby tag:\n");
+	for (int i = 0; i < SPEL_MEM_TAG_COUNT; ++i)
+	{
+		const spel_memory_tag_stats* ts = &mem.tags[i];
+		if (ts->alloc_count == 0)
+		{
+			continue;
+		}
+
+		char tag_total[32];
+		char tag_largest[32];
+		printf("    %s%-8s%s  %-10s	 %s%sallocs: %s%zu%s	"
+			   "%s%s(largest block = %s%s%s)%s\n",
+			   spel_terminal_bright_blue, spel_mem_tag_names[i], spel_terminal_reset,
+			   spel_memory_fmt_size(ts->bytes_total, tag_total, true),
+			   spel_terminal_bright_blue, spel_terminal_italic, spel_terminal_bright_green,
+			   ts->alloc_count, spel_terminal_reset, spel_terminal_italic,
+			   spel_terminal_gray,
+			   spel_memory_fmt_size(ts->largest_block, tag_largest, true),
+			   spel_terminal_italic, spel_terminal_gray, spel_terminal_reset);
+	}
+#else
+	char cur[32];
+	char freed[32];
+
 	printf("global:\n");
 	printf("    %scurrent%s:  %s\n", spel_terminal_bright_blue, spel_terminal_reset,
-		   spel_memory_fmt_size(spel.memory.current, cur, true));
+		   spel_memory_fmt_size(mem.current, cur, true));
 
 	printf("    %speak%s:     %s\n", spel_terminal_bright_blue, spel_terminal_reset,
-		   spel_memory_fmt_size(spel.memory.peak, peak, true));
+		   spel_memory_fmt_size(mem.peak, peak, true));
 	printf("    %stotal%s:    %s %s%s(%s%s%s freed)%s\n", spel_terminal_bright_blue,
 		   spel_terminal_reset,
-		   spel_memory_fmt_size(spel.memory.total_allocated, total, true),
+		   spel_memory_fmt_size(mem.total_allocated, total, true),
 		   spel_terminal_italic, spel_terminal_gray,
-		   spel_memory_fmt_size(spel.memory.total_freed, freed, true), spel_terminal_gray,
+		   spel_memory_fmt_size(mem.total_freed, freed, true), spel_terminal_gray,
 		   spel_terminal_italic, spel_terminal_reset);
 
 	printf("    %sallocs%s:   %s%zu%s\n    %sfrees%s:    %s%zu%s %s%s(%s%zu%s "
 		   "still alive%s)%s\n",
 		   spel_terminal_bright_blue, spel_terminal_reset, spel_terminal_bright_green,
-		   spel.memory.alloc_count, spel_terminal_reset, spel_terminal_bright_blue,
-		   spel_terminal_reset, spel_terminal_bright_green, spel.memory.free_count,
+		   mem.alloc_count, spel_terminal_reset, spel_terminal_bright_blue,
+		   spel_terminal_reset, spel_terminal_bright_green, mem.free_count,
 		   spel_terminal_reset, spel_terminal_italic, spel_terminal_gray,
-		   spel_terminal_bright_yellow, spel.memory.alloc_count - spel.memory.free_count,
+		   spel_terminal_bright_yellow, mem.alloc_count - mem.free_count,
 		   spel_terminal_italic, spel_terminal_gray, spel_terminal_reset);
 
 	printf("\nby tag:\n");
 	for (int i = 0; i < SPEL_MEM_TAG_COUNT; ++i)
 	{
-		const spel_memory_tag_stats* ts = &spel.memory.tags[i];
+		const spel_memory_tag_stats* ts = &mem.tags[i];
 		if (ts->alloc_count == 0)
 		{
 			continue;
@@ -284,6 +951,41 @@ spel_api void spel_memory_dump_terminal()
 			   spel_memory_fmt_size(ts->largest_block, tag_peak, true),
 			   spel_terminal_italic, spel_terminal_gray, spel_terminal_reset);
 	}
+#endif
+
+	if (spel.memory.frame.capacity)
+	{
+		char used[32];
+		char cap[32];
+		printf("\nframe arena:\n");
+		printf("    %sused%s:     %s %s%s(peak %s%s%s)%s\n", spel_terminal_bright_blue,
+			   spel_terminal_reset,
+			   spel_memory_fmt_size(spel.memory.frame.offset, used, true),
+			   spel_terminal_italic, spel_terminal_gray,
+			   spel_memory_fmt_size(spel.memory.frame.peak, peak, true),
+			   spel_terminal_italic, spel_terminal_gray, spel_terminal_reset);
+		printf("    %scapacity%s: %s %s%s(%zu spills this frame)%s\n",
+			   spel_terminal_bright_blue, spel_terminal_reset,
+			   spel_memory_fmt_size(spel.memory.frame.capacity, cap, true),
+			   spel_terminal_italic, spel_terminal_gray, spel.memory.frame.spill_count,
+			   spel_terminal_reset);
+	}
+
+	if (spel.memory.pools)
+	{
+		printf("\npools:\n");
+		for (spel_memory_pool* pool = spel.memory.pools; pool; pool = pool->next)
+		{
+			uint32_t capacity = pool->slab_count * pool->slots_per_slab;
+			char bytes[32];
+			printf("    %s%-24s%s %s%u%s/%u slots  %s%s(peak %u, %u slabs, %s%s%s)%s\n",
+				   spel_terminal_bright_blue, pool->name, spel_terminal_reset,
+				   spel_terminal_bright_green, pool->used, spel_terminal_reset, capacity,
+				   spel_terminal_italic, spel_terminal_gray, pool->peak, pool->slab_count,
+				   spel_memory_fmt_size((size_t)capacity * pool->slot_size, bytes, true),
+				   spel_terminal_italic, spel_terminal_gray, spel_terminal_reset);
+		}
+	}
 
 	printf("%s%s===========================%s\n", spel_terminal_bright_green,
 		   spel_terminal_bold, spel_terminal_reset);
@@ -296,13 +998,7 @@ void* sdl_spel_malloc(size_t size)
 
 void* sdl_spel_calloc(size_t nmemb, size_t size)
 {
-	size_t total_size;
-	if (__builtin_mul_overflow(nmemb, size, &total_size))
-	{
-		return NULL;
-	}
-
-	return spel_memory_malloc(total_size, SPEL_MEM_TAG_MISC);
+	return spel_memory_calloc(nmemb, size, SPEL_MEM_TAG_MISC);
 }
 
 void* sdl_spel_realloc(void* mem, size_t size)
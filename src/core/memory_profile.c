@@ -0,0 +1,353 @@
+#define _GNU_SOURCE
+#include "core/log.h"
+#include "core/memory.h"
+#include <stdatomic.h>
+
+_Atomic bool spel_memory_profiling = false;
+
+#ifdef SPEL_ALLOC_PROFILE
+#	include "utils/internal/xxhash.h"
+#	include <dlfcn.h>
+#	include <pthread.h>
+#	include <stdio.h>
+#	include <stdlib.h>
+#	include <string.h>
+
+#define SPEL_PROFILE_DEPTH 24
+#define SPEL_PROFILE_INITIAL_SITES 1024
+
+typedef struct
+{
+	uint64_t hash;
+	uint64_t bytes;
+	uint64_t count;
+	uint32_t depth;
+	void* frames[SPEL_PROFILE_DEPTH];
+} spel_alloc_site;
+
+// the table lives on the libc heap on purpose, going through spel_memory_malloc
+// from inside the hook would just sample ourselves
+static struct
+{
+	spel_alloc_site* sites;
+	uint32_t capacity;
+	uint32_t count;
+	uint32_t every;
+	atomic_flag lock;
+} spel_profile = {.lock = ATOMIC_FLAG_INIT};
+
+static spel_thread_local uint32_t spel_profile_tick = 0;
+static spel_thread_local bool spel_profile_busy = false;
+static spel_thread_local uintptr_t spel_profile_stack_lo = 0;
+static spel_thread_local uintptr_t spel_profile_stack_hi = 0;
+
+// looked up once per thread, an empty range when the platform won't say
+static void spel_profile_stack_bounds(uintptr_t* lo, uintptr_t* hi)
+{
+	if (spel_profile_stack_hi == 0)
+	{
+		spel_profile_stack_lo = 1;
+		spel_profile_stack_hi = 1;
+
+#	ifdef __APPLE__
+		pthread_t self = pthread_self();
+		uintptr_t top = (uintptr_t)pthread_get_stackaddr_np(self);
+		spel_profile_stack_lo = top - pthread_get_stacksize_np(self);
+		spel_profile_stack_hi = top;
+#	else
+		pthread_attr_t attr;
+		if (pthread_getattr_np(pthread_self(), &attr) == 0)
+		{
+			void* addr;
+			size_t size;
+			if (pthread_attr_getstack(&attr, &addr, &size) == 0)
+			{
+				spel_profile_stack_lo = (uintptr_t)addr;
+				spel_profile_stack_hi = (uintptr_t)addr + size;
+			}
+			pthread_attr_destroy(&attr);
+		}
+#	endif
+	}
+
+	*lo = spel_profile_stack_lo;
+	*hi = spel_profile_stack_hi;
+}
+
+// follows the frame pointer chain only while every frame sits on this thread's
+// stack above the last one. a frame built without frame pointers (sdl, drivers)
+// ends the walk instead of sending it off into random memory
+static int spel_profile_walk(void** frames, int maxDepth)
+{
+	uintptr_t lo;
+	uintptr_t hi;
+	spel_profile_stack_bounds(&lo, &hi);
+	if (hi - lo < 2 * sizeof(void*))
+	{
+		return 0;
+	}
+
+	uintptr_t fp = (uintptr_t)__builtin_frame_address(0);
+	int depth = 0;
+
+	while (depth < maxDepth && fp >= lo && fp <= hi - 2 * sizeof(void*) &&
+		   (fp & (sizeof(void*) - 1)) == 0)
+	{
+		void** frame = (void**)fp;
+		void* ret = frame[1];
+		if (!ret)
+		{
+			break;
+		}
+
+		frames[depth++] = ret;
+
+		uintptr_t next = (uintptr_t)frame[0];
+		if (next <= fp)
+		{
+			break;
+		}
+		fp = next;
+	}
+
+	return depth;
+}
+
+static void spel_profile_lock()
+{
+	while (atomic_flag_test_and_set_explicit(&spel_profile.lock, memory_order_acquire))
+	{
+	}
+}
+
+static void spel_profile_unlock()
+{
+	atomic_flag_clear_explicit(&spel_profile.lock, memory_order_release);
+}
+
+static bool spel_profile_grow()
+{
+	uint32_t capacity =
+		spel_profile.capacity ? spel_profile.capacity * 2 : SPEL_PROFILE_INITIAL_SITES;
+	spel_alloc_site* sites = calloc(capacity, sizeof(*sites));
+	if (!sites)
+	{
+		return false;
+	}
+
+	for (uint32_t i = 0; i < spel_profile.capacity; i++)
+	{
+		spel_alloc_site* old = &spel_profile.sites[i];
+		if (old->count == 0)
+		{
+			continue;
+		}
+
+		uint32_t index = (uint32_t)old->hash & (capacity - 1);
+		while (sites[index].count != 0)
+		{
+			index = (index + 1) & (capacity - 1);
+		}
+		sites[index] = *old;
+	}
+
+	free(spel_profile.sites);
+	spel_profile.sites = sites;
+	spel_profile.capacity = capacity;
+	return true;
+}
+
+spel_api void spel_memory_profile_start(uint32_t sampleEvery)
+{
+	spel_profile_lock();
+	spel_profile.every = sampleEvery ? sampleEvery : 1;
+	if (!spel_profile.sites)
+	{
+		spel_profile_grow();
+	}
+	spel_profile_unlock();
+
+	atomic_store_explicit(&spel_memory_profiling, true, memory_order_release);
+}
+
+spel_api void spel_memory_profile_stop()
+{
+	atomic_store_explicit(&spel_memory_profiling, false, memory_order_release);
+}
+
+spel_hidden void spel_memory_profile_record(size_t size)
+{
+	if (spel_profile_busy || ++spel_profile_tick < spel_profile.every)
+	{
+		return;
+	}
+	spel_profile_tick = 0;
+	spel_profile_busy = true;
+
+	void* frames[SPEL_PROFILE_DEPTH];
+	int depth = spel_profile_walk(frames, SPEL_PROFILE_DEPTH);
+	uint64_t hash = XXH3_64bits(frames, (size_t)depth * sizeof(void*));
+
+	spel_profile_lock();
+
+	if (spel_profile.capacity == 0 || spel_profile.count * 10 >= spel_profile.capacity * 7)
+	{
+		if (!spel_profile_grow())
+		{
+			spel_profile_unlock();
+			spel_profile_busy = false;
+			return;
+		}
+	}
+
+	uint32_t mask = spel_profile.capacity - 1;
+	uint32_t index = (uint32_t)hash & mask;
+	for (;;)
+	{
+		spel_alloc_site* site = &spel_profile.sites[index];
+		if (site->count == 0)
+		{
+			site->hash = hash;
+			site->depth = (uint32_t)depth;
+			memcpy(site->frames, frames, (size_t)depth * sizeof(void*));
+			spel_profile.count++;
+		}
+
+		if (site->hash == hash)
+		{
+			site->bytes += size;
+			site->count++;
+			break;
+		}
+
+		index = (index + 1) & mask;
+	}
+
+	spel_profile_unlock();
+	spel_profile_busy = false;
+}
+
+// the profiler and the allocator itself show up on top of every stack
+static bool spel_profile_frame_internal(const char* name)
+{
+	return strncmp(name, "spel_memory_", strlen("spel_memory_")) == 0 ||
+		   strncmp(name, "sdl_spel_", strlen("sdl_spel_")) == 0;
+}
+
+static void spel_profile_frame_name(void* addr, char* buf, size_t bufSize)
+{
+	Dl_info info;
+	void* lookup = (void*)((uintptr_t)addr - 1);
+
+	if (dladdr(lookup, &info) == 0)
+	{
+		snprintf(buf, bufSize, "%p", addr);
+		return;
+	}
+
+	if (info.dli_sname)
+	{
+		snprintf(buf, bufSize, "%s", info.dli_sname);
+		return;
+	}
+
+	if (info.dli_fname)
+	{
+		const char* base = strrchr(info.dli_fname, '/');
+		snprintf(buf, bufSize, "%s+0x%tx", base ? base + 1 : info.dli_fname,
+				 (char*)lookup - (char*)info.dli_fbase);
+		return;
+	}
+
+	snprintf(buf, bufSize, "%p", addr);
+}
+
+spel_api bool spel_memory_profile_dump(const char* path)
+{
+	FILE* file = fopen(path, "w");
+	if (!file)
+	{
+		spel_error(SPEL_ERR_FILE_NOT_FOUND, "couldn't open %s for the allocation profile",
+				   path);
+		return false;
+	}
+
+	spel_profile_lock();
+
+	char names[SPEL_PROFILE_DEPTH][256];
+	for (uint32_t i = 0; i < spel_profile.capacity; i++)
+	{
+		spel_alloc_site* site = &spel_profile.sites[i];
+		if (site->count == 0)
+		{
+			continue;
+		}
+
+		// innermost frame first in the walk, folded stacks want the root first
+		int first = 0;
+		for (int f = 0; f < (int)site->depth; f++)
+		{
+			spel_profile_frame_name(site->frames[f], names[f], sizeof(names[f]));
+		}
+
+		while (first < (int)site->depth - 1 && spel_profile_frame_internal(names[first]))
+		{
+			first++;
+		}
+
+		for (int f = (int)site->depth - 1; f >= first; f--)
+		{
+			fprintf(file, "%s%s", names[f], f == first ? "" : ";");
+		}
+
+		// sampled, so scale back up to an estimate of the real byte count
+		fprintf(file, " %llu\n", (unsigned long long)(site->bytes * spel_profile.every));
+	}
+
+	uint32_t sites = spel_profile.count;
+	spel_profile_unlock();
+
+	fclose(file);
+	spel_debug("wrote %u allocation sites to %s", sites, path);
+	return true;
+}
+
+spel_hidden void spel_memory_profile_shutdown()
+{
+	spel_memory_profile_stop();
+
+	spel_profile_lock();
+	free(spel_profile.sites);
+	spel_profile.sites = NULL;
+	spel_profile.capacity = 0;
+	spel_profile.count = 0;
+	spel_profile_unlock();
+}
+#else
+// no frame pointers or no dladdr in this build, see alloc_profile in meson
+spel_api void spel_memory_profile_start(uint32_t sampleEvery)
+{
+	spel_unused(sampleEvery);
+	spel_warn("allocation profiling isn't built in, it needs frame pointers: rebuild "
+			  "with -Dalloc_profile=true or as a debug build");
+}
+
+spel_api void spel_memory_profile_stop()
+{
+}
+
+spel_api bool spel_memory_profile_dump(const char* path)
+{
+	spel_unused(path);
+	return false;
+}
+
+spel_hidden void spel_memory_profile_record(size_t size)
+{
+	spel_unused(size);
+}
+
+spel_hidden void spel_memory_profile_shutdown()
+{
+}
+#endif
@@ -13,6 +13,7 @@
 #include "gfx/gfx_pipeline.h"
 #include "gfx_internal_shaders.h"
 #include <stddef.h>
+#include <string.h>
 
 typedef struct spel_imgui_context_t
 {
@@ -26,8 +27,8 @@ typedef struct spel_imgui_context_t
 	spel_gfx_shader vtx_shader;
 	spel_gfx_shader frag_shader;
 
-	spel_gfx_buffer vbuffer;
-	spel_gfx_buffer ibuffer;
+	spel_gfx_ring vring;
+	spel_gfx_ring iring;
 
 	spel_gfx_uniform matrix_handle;
 	spel_gfx_uniform_buffer ubuffer;
@@ -38,7 +39,6 @@ typedef struct spel_imgui_context_t
 spel_hidden void spel_imgui_resources_create(spel_imgui_context ctx);
 spel_hidden void spel_imgui_texture_update(spel_imgui_context ctx,
 										   ImTextureData* texture);
-spel_hidden void spel_imgui_buffers_check(spel_imgui_context ctx, ImDrawData* drawData);
 spel_hidden void spel_imgui_state_update(spel_imgui_context ctx, spel_gfx_cmdlist cl,
 										 ImDrawData* drawData);
 
@@ -46,7 +46,7 @@ spel_hidden bool spel_imgui_event_callback(void* event, void* ctx);
 
 spel_api spel_imgui_context spel_imgui_context_create(spel_gfx_context gfx)
 {
-	spel_imgui_context ctx = spel_memory_malloc(sizeof(*ctx), SPEL_MEM_TAG_MISC);
+	spel_imgui_context ctx = spel_memory_calloc(1, sizeof(*ctx), SPEL_MEM_TAG_MISC);
 
 	ctx->gfx = gfx;
 
@@ -69,8 +69,8 @@ spel_api spel_imgui_context spel_imgui_context_create(spel_gfx_context gfx)
 	ctx->io->ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
 
 	ctx->pipeline = NULL;
-	ctx->vbuffer = NULL;
-	ctx->ibuffer = NULL;
+	ctx->vring = NULL;
+	ctx->iring = NULL;
 
 	cImGui_ImplSDL3_InitForOther(spel.window.handle);
 
@@ -113,9 +113,17 @@ spel_api void spel_imgui_render(spel_imgui_context ctx, spel_gfx_cmdlist cl)
 		return;
 	}
 
-	spel_imgui_buffers_check(ctx, draw_data);
+	size_t vtx_size = (size_t)draw_data->TotalVtxCount * sizeof(ImDrawVert);
+	size_t idx_size = (size_t)draw_data->TotalIdxCount * sizeof(ImDrawIdx);
+	if (vtx_size == 0 || idx_size == 0)
+	{
+		return;
+	}
 
-	if (ctx->vbuffer == NULL || ctx->ibuffer == NULL)
+	// one slice covers every draw list, copied in back to back
+	spel_gfx_ring_slice vtx = spel_gfx_ring_alloc(ctx->vring, vtx_size, 4);
+	spel_gfx_ring_slice idx = spel_gfx_ring_alloc(ctx->iring, idx_size, 4);
+	if (vtx.data == NULL || idx.data == NULL)
 	{
 		return;
 	}
@@ -150,13 +158,11 @@ spel_api void spel_imgui_render(spel_imgui_context ctx, spel_gfx_cmdlist cl)
 	{
 		const ImDrawList* list = draw_data->CmdLists.Data[i];
 
-		spel_gfx_buffer_update(ctx->vbuffer, list->VtxBuffer.Data,
-							   list->VtxBuffer.Size * sizeof(ImDrawVert),
-							   vtx_offset_elements * sizeof(ImDrawVert));
+		memcpy((ImDrawVert*)vtx.data + vtx_offset_elements, list->VtxBuffer.Data,
+			   list->VtxBuffer.Size * sizeof(ImDrawVert));
 
-		spel_gfx_buffer_update(ctx->ibuffer, list->IdxBuffer.Data,
-							   list->IdxBuffer.Size * sizeof(ImDrawIdx),
-							   idx_offset_elements * sizeof(ImDrawIdx));
+		memcpy((ImDrawIdx*)idx.data + idx_offset_elements, list->IdxBuffer.Data,
+			   list->IdxBuffer.Size * sizeof(ImDrawIdx));
 
 		spel_gfx_cmd_bind_shader_buffer(cl, ctx->ubuffer);
 
@@ -193,10 +199,11 @@ spel_api void spel_imgui_render(spel_imgui_context ctx, spel_gfx_cmdlist cl)
 					cl, 0, (spel_gfx_texture)((uintptr_t)ImDrawCmd_GetTexID(pcmd)));
 
 				spel_gfx_cmd_bind_index(
-					cl, ctx->ibuffer,
-					sizeof(ImDrawIdx) == 2 ? SPEL_GFX_INDEX_U16 : SPEL_GFX_INDEX_U32, 0);
+					cl, idx.buffer,
+					sizeof(ImDrawIdx) == 2 ? SPEL_GFX_INDEX_U16 : SPEL_GFX_INDEX_U32,
+					idx.offset);
 
-				spel_gfx_cmd_bind_vertex(cl, 0, ctx->vbuffer, 0);
+				spel_gfx_cmd_bind_vertex(cl, 0, vtx.buffer, vtx.offset);
 
 				spel_gfx_cmd_draw_indexed(cl, pcmd->ElemCount,
 										  idx_offset_elements + pcmd->IdxOffset,
@@ -215,6 +222,8 @@ spel_hidden void spel_imgui_resources_create(spel_imgui_context ctx)
 {
 	spel_gfx_shader_desc frag_shader_desc;
 	frag_shader_desc.shader_source = SPEL_GFX_SHADER_STATIC;
+	frag_shader_desc.constants = NULL;
+	frag_shader_desc.constant_count = 0;
 	frag_shader_desc.source = spel_internal_imgui_frag_spv;
 	frag_shader_desc.source_size = spel_internal_imgui_frag_spv_len;
 	frag_shader_desc.debug_name = "spel_internal_imgui_frag";
@@ -223,6 +232,8 @@ spel_hidden void spel_imgui_resources_create(spel_imgui_context ctx)
 	{
 		spel_gfx_shader_desc vertex_desc;
 		vertex_desc.shader_source = SPEL_GFX_SHADER_STATIC;
+		vertex_desc.constants = NULL;
+		vertex_desc.constant_count = 0;
 		vertex_desc.debug_name = "spel_internal_2d_vertex";
 		vertex_desc.source = spel_internal_2d_vert_spv;
 		vertex_desc.source_size = spel_internal_2d_vert_spv_len;
@@ -247,6 +258,9 @@ spel_hidden void spel_imgui_resources_create(spel_imgui_context ctx)
 	ctx->ubuffer = spel_gfx_uniform_buffer_create(ctx->pipeline, "FrameData");
 	ctx->matrix_handle = spel_gfx_uniform_get(ctx->pipeline, "proj");
 
+	ctx->vring = spel_gfx_ring_create(ctx->gfx, SPEL_GFX_BUFFER_VERTEX, 256 * 1024);
+	ctx->iring = spel_gfx_ring_create(ctx->gfx, SPEL_GFX_BUFFER_INDEX, 128 * 1024);
+
 	unsigned char* pixels;
 	int bpp;
 	int width;
@@ -279,14 +293,14 @@ spel_api void spel_imgui_context_destroy(spel_imgui_context ctx)
 	cImGui_ImplSDL3_Shutdown();
 	ImGui_DestroyContext(ctx->context);
 
-	if (ctx->vbuffer)
+	if (ctx->vring)
 	{
-		spel_gfx_buffer_destroy(ctx->vbuffer);
+		spel_gfx_ring_destroy(ctx->vring);
 	}
 
-	if (ctx->ibuffer)
+	if (ctx->iring)
 	{
-		spel_gfx_buffer_destroy(ctx->ibuffer);
+		spel_gfx_ring_destroy(ctx->iring);
 	}
 
 	spel_gfx_uniform_buffer_destroy(ctx->ubuffer);
@@ -296,46 +310,6 @@ spel_api void spel_imgui_context_destroy(spel_imgui_context ctx)
 	spel_memory_free(ctx);
 }
 
-spel_hidden void spel_imgui_buffers_check(spel_imgui_context ctx, ImDrawData* drawData)
-{
-	uint32_t vtx_size = drawData->TotalVtxCount * sizeof(ImDrawVert);
-	uint32_t idx_size = drawData->TotalIdxCount * sizeof(ImDrawIdx);
-
-	if (vtx_size != 0)
-	{
-		if (!ctx->vbuffer)
-		{
-			spel_gfx_buffer_desc vb_desc = {.type = SPEL_GFX_BUFFER_VERTEX,
-											.usage = SPEL_GFX_USAGE_DYNAMIC,
-											.access = SPEL_GFX_BUFFER_DRAW,
-											.size = (size_t)vtx_size * 2,
-											.data = NULL};
-			ctx->vbuffer = spel_gfx_buffer_create(ctx->gfx, &vb_desc);
-		}
-		else if (spel_gfx_buffer_size(ctx->vbuffer) < vtx_size)
-		{
-			spel_gfx_buffer_resize(ctx->vbuffer, (size_t)vtx_size * 2, false);
-		}
-	}
-
-	if (idx_size != 0)
-	{
-		if (!ctx->ibuffer)
-		{
-			spel_gfx_buffer_desc ib_desc = {.type = SPEL_GFX_BUFFER_INDEX,
-											.usage = SPEL_GFX_USAGE_DYNAMIC,
-											.access = SPEL_GFX_BUFFER_DRAW,
-											.size = (size_t)idx_size * 2,
-											.data = NULL};
-			ctx->ibuffer = spel_gfx_buffer_create(ctx->gfx, &ib_desc);
-		}
-		else if (spel_gfx_buffer_size(ctx->ibuffer) < idx_size)
-		{
-			spel_gfx_buffer_resize(ctx->ibuffer, (size_t)idx_size * 2, false);
-		}
-	}
-}
-
 spel_hidden void spel_imgui_texture_update(spel_imgui_context ctx, ImTextureData* texture)
 {
 	spel_assert(texture->TexID != 0, "tried to update empty texture %p", texture->TexID);
@@ -2,6 +2,7 @@
 #include "core/log.h"
 #include "gfx/gfx_internal.h"
 #include "gfx/gfx_types.h"
+#include "gfx_vtable_gl.h"
 #include "gl.h"
 #include "gl_types.h"
 #include <stdint.h>
@@ -9,40 +10,62 @@
 
 GLbitfield spel_gfx_gl_map_access(spel_gfx_access access);
 
+// persistent buffers are written through their mapping only, so no dynamic storage
+// (and no read back), which lets the driver put them in write-combined memory
+static const GLbitfield spel_gl_persistent_flags =
+	GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+static GLbitfield spel_gl_storage_flags(bool persistent)
+{
+	if (persistent)
+	{
+		return spel_gl_persistent_flags;
+	}
+
+	return GL_DYNAMIC_STORAGE_BIT | GL_MAP_READ_BIT | GL_MAP_WRITE_BIT |
+		   GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+}
+
 spel_gfx_buffer spel_gfx_buffer_create_gl(spel_gfx_context ctx,
 										  const spel_gfx_buffer_desc* desc)
 {
-	spel_gfx_buffer buf =
-		(spel_gfx_buffer)spel_memory_malloc(sizeof(*buf), SPEL_MEM_TAG_GFX);
-	if (!buf)
+	spel_memory_pool* pool = &((spel_gfx_context_gl*)ctx->data)->pools.buffers;
+	spel_gfx_buffer_slot_gl* slot = spel_memory_pool_alloc(pool);
+	if (!slot)
 	{
 		spel_error(SPEL_ERR_OOM, "failed to allocate buffer object");
 		return NULL;
 	}
 
+	spel_gfx_buffer buf = &slot->handle;
 	buf->ctx = ctx;
-	buf->data = spel_memory_malloc(sizeof(spel_gfx_gl_buffer), SPEL_MEM_TAG_GFX);
-	if (!buf->data)
-	{
-		spel_error(SPEL_ERR_OOM, "failed to allocate GL handle storage");
-		spel_memory_free(buf);
-		return NULL;
-	}
+	buf->data = &slot->gl;
 
-	buf->persistent = false;
+	buf->persistent = desc->persistent;
 	buf->type = desc->type;
 	buf->access = desc->access;
 	buf->size = desc->size;
 
 	spel_gfx_gl_buffer* glBuf = (spel_gfx_gl_buffer*)buf->data;
 	glBuf->mirror = NULL;
+	glBuf->mapped = NULL;
 	glBuf->dirty_min = UINT32_MAX;
 	glBuf->dirty_max = 0;
 
-	// TODO: Change into persistent mapping later (fences and all that)
-	if (desc->type == SPEL_GFX_BUFFER_UNIFORM || desc->type == SPEL_GFX_BUFFER_STORAGE)
+	if (desc->type == SPEL_GFX_BUFFER_INDIRECT && desc->size % 4 != 0)
+	{
+		spel_warn("indirect buffer size %zu isn't a multiple of 4, the tail can't hold "
+				  "draw arguments",
+				  desc->size);
+	}
+
+	// persistent buffers are written straight through the mapping, the mirror is
+	// only there to batch glNamedBufferSubData calls
+	bool shadowed =
+		desc->type == SPEL_GFX_BUFFER_UNIFORM || desc->type == SPEL_GFX_BUFFER_STORAGE;
+	if (shadowed && !desc->persistent)
 	{
-		glBuf->mirror = spel_memory_malloc(desc->size, SPEL_MEM_TAG_GFX);
+		glBuf->mirror = spel_memory_calloc(1, desc->size, SPEL_MEM_TAG_GFX);
 
 		if (desc->data != NULL)
 		{
@@ -54,26 +77,37 @@ spel_gfx_buffer spel_gfx_buffer_create_gl(spel_gfx_context ctx,
 	if (glBuf->buffer == 0)
 	{
 		spel_error(SPEL_ERR_CONTEXT_FAILED, "glCreateBuffers returned 0");
-		spel_memory_free(buf->data);
-		spel_memory_free(buf);
+		spel_memory_free(glBuf->mirror);
+		spel_memory_pool_free(pool, slot);
 		return NULL;
 	}
 
-	GLbitfield storage_flags = GL_DYNAMIC_STORAGE_BIT | GL_MAP_READ_BIT |
-							   GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT |
-							   GL_MAP_COHERENT_BIT;
-
-	glNamedBufferStorage(glBuf->buffer, desc->size, desc->data, storage_flags);
+	glNamedBufferStorage(glBuf->buffer, desc->size, desc->data,
+						 spel_gl_storage_flags(desc->persistent));
 	GLenum err = glGetError();
 	if (err != GL_NO_ERROR)
 	{
 		spel_error(SPEL_ERR_INVALID_STATE, "glNamedBufferStorage error 0x%x", err);
-		glDeleteBuffers(1, &((spel_gfx_gl_buffer*)buf->data)->buffer);
-		spel_memory_free(buf->data);
-		spel_memory_free(buf);
+		glDeleteBuffers(1, &glBuf->buffer);
+		spel_memory_free(glBuf->mirror);
+		spel_memory_pool_free(pool, slot);
 		return NULL;
 	}
 
+	if (buf->persistent)
+	{
+		glBuf->mapped = glMapNamedBufferRange(glBuf->buffer, 0, (GLsizeiptr)desc->size,
+											  spel_gl_persistent_flags);
+		if (glBuf->mapped == NULL)
+		{
+			spel_error(SPEL_ERR_CONTEXT_FAILED, "failed to persistently map buffer %u",
+					   glBuf->buffer);
+			glDeleteBuffers(1, &glBuf->buffer);
+			spel_memory_pool_free(pool, slot);
+			return NULL;
+		}
+	}
+
 	spel_trace("created GL buffer %u size=%zu", glBuf->buffer, desc->size);
 
 	return buf;
@@ -86,23 +120,48 @@ void spel_gfx_buffer_destroy_gl(spel_gfx_buffer buf)
 		spel_memory_free(((spel_gfx_gl_buffer*)buf->data)->mirror);
 	}
 
+	// queued uploads still point at this buffer
+	spel_gl_upload_flush(buf->ctx);
+
 	GLuint handle = ((spel_gfx_gl_buffer*)buf->data)->buffer;
+
+	// deleting a bound buffer unbinds it, keep the shadow honest
+	spel_gfx_context_gl* gl = (spel_gfx_context_gl*)buf->ctx->data;
+	if (gl->bound.indirect == handle)
+	{
+		gl->bound.indirect = 0;
+	}
+	if (gl->bound.dispatch_indirect == handle)
+	{
+		gl->bound.dispatch_indirect = 0;
+	}
+
 	glDeleteBuffers(1, &handle);
 	spel_trace("destroyed GL buffer %u", handle);
-	spel_memory_free(buf->data);
-	spel_memory_free(buf);
+	spel_memory_pool_free(&((spel_gfx_context_gl*)buf->ctx->data)->pools.buffers, buf);
 }
 
 void spel_gfx_buffer_update_gl(spel_gfx_buffer buf, const void* data, size_t size,
 							   size_t offset)
 {
-	glNamedBufferSubData(((spel_gfx_gl_buffer*)buf->data)->buffer, (GLintptr)offset,
-						 (GLsizeiptr)size, data);
+	// persistent buffers go through the staging copy too, a memcpy into the
+	// mapping could land while earlier frames still read the old contents. the
+	// copy is ordered after them on the gpu
+	spel_gl_upload_buffer(buf, data, size, offset);
 }
 
 void* spel_gfx_buffer_map_gl(spel_gfx_buffer buf, size_t offset, size_t size,
 							 spel_gfx_access access)
 {
+	spel_gfx_gl_buffer* glBuf = (spel_gfx_gl_buffer*)buf->data;
+	if (glBuf->mapped)
+	{
+		return (uint8_t*)glBuf->mapped + offset;
+	}
+
+	// whatever gets read back has to include the queued uploads
+	spel_gl_upload_flush(buf->ctx);
+
 	GLbitfield flags = spel_gfx_gl_map_access(access);
 	buf->persistent = (access & spel_gfx_access_persistent) != 0;
 	return glMapNamedBufferRange(((spel_gfx_gl_buffer*)buf->data)->buffer, offset, size,
@@ -121,6 +180,12 @@ void spel_gfx_buffer_unmap_gl(spel_gfx_buffer buf)
 
 void spel_gfx_buffer_flush_gl(spel_gfx_buffer buf, size_t offset, size_t size)
 {
+	// coherent, writes are visible on their own
+	if (((spel_gfx_gl_buffer*)buf->data)->mapped)
+	{
+		return;
+	}
+
 	if (buf->type == SPEL_GFX_BUFFER_UNIFORM || buf->type == SPEL_GFX_BUFFER_STORAGE)
 	{
 		spel_gfx_gl_buffer* glBuf = (spel_gfx_gl_buffer*)buf->data;
@@ -206,6 +271,9 @@ GLbitfield spel_gfx_gl_map_access(spel_gfx_access access)
 spel_hidden void spel_gfx_buffer_resize_gl(spel_gfx_buffer buf, size_t newSize,
 										 bool preserveData)
 {
+	spel_gl_upload_flush(buf->ctx);
+
+	spel_gfx_gl_buffer* glBuf = (spel_gfx_gl_buffer*)buf->data;
 	GLuint handle = ((spel_gfx_gl_buffer*)buf->data)->buffer;
 	void* old_mirror = ((spel_gfx_gl_buffer*)buf->data)->mirror;
 	size_t old_size = buf->size;
@@ -214,22 +282,18 @@ spel_hidden void spel_gfx_buffer_resize_gl(spel_gfx_buffer buf, size_t newSize,
 	if (((spel_gfx_gl_buffer*)buf->data)->buffer == 0)
 	{
 		spel_error(SPEL_ERR_CONTEXT_FAILED, "glCreateBuffers returned 0");
-		buf->data = &handle;
+		glBuf->buffer = handle;
 		return;
 	}
 
-	GLbitfield storage_flags = GL_DYNAMIC_STORAGE_BIT | GL_MAP_READ_BIT |
-							   GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT |
-							   GL_MAP_COHERENT_BIT;
-
 	glNamedBufferStorage(((spel_gfx_gl_buffer*)buf->data)->buffer, newSize, NULL,
-						 storage_flags);
+						 spel_gl_storage_flags(glBuf->mapped != NULL));
 	GLenum err = glGetError();
 	if (err != GL_NO_ERROR)
 	{
 		spel_error(SPEL_ERR_INVALID_STATE, "glNamedBufferStorage error 0x%x", err);
 		glDeleteBuffers(1, &((spel_gfx_gl_buffer*)buf->data)->buffer);
-		buf->data = &handle;
+		glBuf->buffer = handle;
 		return;
 	}
 
@@ -244,24 +308,30 @@ spel_hidden void spel_gfx_buffer_resize_gl(spel_gfx_buffer buf, size_t newSize,
 
 	buf->size = newSize;
 	glDeleteBuffers(1, &handle);
-	if (buf->type == SPEL_GFX_BUFFER_UNIFORM || buf->type == SPEL_GFX_BUFFER_STORAGE)
+
+	if (glBuf->mapped)
 	{
-		spel_memory_free(old_mirror);
+		glBuf->mapped = glMapNamedBufferRange(glBuf->buffer, 0, (GLsizeiptr)newSize,
+											  spel_gl_persistent_flags);
 	}
 
-	// TODO: Change into persistent mapping later (fences and all that)
-	if (buf->type == SPEL_GFX_BUFFER_UNIFORM || buf->type == SPEL_GFX_BUFFER_STORAGE)
+	if ((buf->type == SPEL_GFX_BUFFER_UNIFORM || buf->type == SPEL_GFX_BUFFER_STORAGE) &&
+		!glBuf->mapped)
 	{
-		((spel_gfx_gl_buffer*)buf->data)->mirror =
-			spel_memory_malloc(buf->size, SPEL_MEM_TAG_GFX);
+		// calloc, thin builds don't zero and the grown tail has to match the gpu side
+		glBuf->mirror = spel_memory_calloc(1, buf->size, SPEL_MEM_TAG_GFX);
 
 		if (preserveData && old_mirror)
 		{
-			memcpy(((spel_gfx_gl_buffer*)buf->data)->mirror, old_mirror,
-				   old_size < buf->size ? old_size : buf->size);
+			memcpy(glBuf->mirror, old_mirror, old_size < buf->size ? old_size : buf->size);
 		}
 	}
 
+	if (buf->type == SPEL_GFX_BUFFER_UNIFORM || buf->type == SPEL_GFX_BUFFER_STORAGE)
+	{
+		spel_memory_free(old_mirror);
+	}
+
 	((spel_gfx_gl_buffer*)buf->data)->dirty_min = UINT32_MAX;
 	((spel_gfx_gl_buffer*)buf->data)->dirty_max = 0;
 }
@@ -8,6 +8,7 @@
 #include "gl_types.h"
 #include <assert.h>
 #include <math.h>
+#include <stdatomic.h>
 #include <stddef.h>
 #include <string.h>
 
@@ -17,6 +18,14 @@ void exec_cmd_bind_index(spel_gfx_cmdlist cl, spel_gfx_bind_index_cmd* cmd);
 void exec_cmd_bind_pipeline(spel_gfx_cmdlist cl, spel_gfx_bind_pipeline_cmd* cmd);
 void exec_cmd_draw(spel_gfx_cmdlist cl, spel_gfx_draw_cmd* cmd);
 void exec_cmd_draw_indexed(spel_gfx_cmdlist cl, spel_gfx_draw_indexed_cmd* cmd);
+void exec_cmd_draw_instanced(spel_gfx_cmdlist cl, spel_gfx_draw_instanced_cmd* cmd);
+void exec_cmd_draw_indexed_instanced(spel_gfx_cmdlist cl,
+									 spel_gfx_draw_indexed_instanced_cmd* cmd);
+void exec_cmd_draw_indirect(spel_gfx_cmdlist cl, spel_gfx_draw_indirect_cmd* cmd);
+void exec_cmd_draw_indexed_indirect(spel_gfx_cmdlist cl, spel_gfx_draw_indirect_cmd* cmd);
+void exec_cmd_dispatch(spel_gfx_cmdlist cl, spel_gfx_dispatch_cmd* cmd);
+void exec_cmd_dispatch_indirect(spel_gfx_cmdlist cl, spel_gfx_dispatch_indirect_cmd* cmd);
+void exec_cmd_barrier(spel_gfx_cmdlist cl, spel_gfx_barrier_cmd* cmd);
 
 void exec_cmd_bind_texture(spel_gfx_cmdlist cl, spel_gfx_bind_texture_cmd* cmd);
 void exec_cmd_bind_sampler(spel_gfx_cmdlist cl, spel_gfx_bind_sampler_cmd* cmd);
@@ -33,32 +42,621 @@ void exec_cmd_uniform_update(spel_gfx_cmdlist cl, spel_gfx_uniform_update_cmd* c
 void exec_cmd_begin_render_pass(spel_gfx_cmdlist cl, spel_gfx_begin_render_pass_cmd* cmd);
 void exec_cmd_end_render_pass(spel_gfx_cmdlist cl, spel_gfx_end_render_pass_cmd* cmd);
 
+static void spel_gl_replay(spel_gfx_cmdlist cl, spel_gfx_cmdlist src);
+
+typedef struct
+{
+	spel_gfx_cmd_chunk* chunk;
+	uint8_t* ptr;
+} spel_gl_cmd_cursor;
+
+static spel_gl_cmd_cursor spel_gl_cursor_begin(spel_gfx_cmdlist src)
+{
+	spel_gl_cmd_cursor cursor = {
+		.chunk = src->head, .ptr = src->head ? spel_gfx_cmd_chunk_data(src->head) : NULL};
+	return cursor;
+}
+
+// NULL once the list runs out (or a header is broken), commands never span chunks
+// so hopping to the next one is all there is to it
+static spel_gfx_cmd_header* spel_gl_cursor_peek(spel_gl_cmd_cursor* cursor)
+{
+	while (cursor->chunk &&
+		   cursor->ptr >= spel_gfx_cmd_chunk_data(cursor->chunk) + cursor->chunk->used)
+	{
+		cursor->chunk = cursor->chunk->next;
+		cursor->ptr = cursor->chunk ? spel_gfx_cmd_chunk_data(cursor->chunk) : NULL;
+	}
+
+	if (!cursor->chunk)
+	{
+		return NULL;
+	}
+
+	spel_gfx_cmd_header* hdr = (spel_gfx_cmd_header*)cursor->ptr;
+	uint64_t remaining = (uint64_t)((spel_gfx_cmd_chunk_data(cursor->chunk) +
+									 cursor->chunk->used) -
+									cursor->ptr);
+
+	if (hdr->size == 0 || hdr->size > remaining)
+	{
+		spel_error(SPEL_ERR_INVALID_STATE, "invalid command header: type %d size %llu",
+				   hdr->type, (unsigned long long)hdr->size);
+		return NULL;
+	}
+
+	return hdr;
+}
+
+static inline void spel_gl_cursor_advance(spel_gl_cmd_cursor* cursor,
+										  spel_gfx_cmd_header* hdr)
+{
+	cursor->ptr += hdr->size;
+}
+
+static void spel_gl_exec_cmd(spel_gfx_cmdlist cl, spel_gfx_cmd_header* hdr)
+{
+	switch (hdr->type)
+	{
+	case SPEL_GFX_CMD_CLEAR:
+		exec_cmd_clear(cl, (spel_gfx_clear_cmd*)hdr);
+		break;
+	case SPEL_GFX_CMD_BIND_VERTEX:
+		exec_cmd_bind_vertex(cl, (spel_gfx_bind_vertex_cmd*)hdr);
+		break;
+	case SPEL_GFX_CMD_BIND_INDEX:
+		exec_cmd_bind_index(cl, (spel_gfx_bind_index_cmd*)hdr);
+		break;
+	case SPEL_GFX_CMD_BIND_PIPELINE:
+		exec_cmd_bind_pipeline(cl, (spel_gfx_bind_pipeline_cmd*)hdr);
+		break;
+	case SPEL_GFX_CMD_DRAW:
+		exec_cmd_draw(cl, (spel_gfx_draw_cmd*)hdr);
+		break;
+	case SPEL_GFX_CMD_DRAW_INDEXED:
+		exec_cmd_draw_indexed(cl, (spel_gfx_draw_indexed_cmd*)hdr);
+		break;
+	case SPEL_GFX_CMD_DRAW_INSTANCED:
+		exec_cmd_draw_instanced(cl, (spel_gfx_draw_instanced_cmd*)hdr);
+		break;
+	case SPEL_GFX_CMD_DRAW_INDEXED_INSTANCED:
+		exec_cmd_draw_indexed_instanced(cl, (spel_gfx_draw_indexed_instanced_cmd*)hdr);
+		break;
+	case SPEL_GFX_CMD_DRAW_INDIRECT:
+		exec_cmd_draw_indirect(cl, (spel_gfx_draw_indirect_cmd*)hdr);
+		break;
+	case SPEL_GFX_CMD_DRAW_INDEXED_INDIRECT:
+		exec_cmd_draw_indexed_indirect(cl, (spel_gfx_draw_indirect_cmd*)hdr);
+		break;
+	case SPEL_GFX_CMD_DISPATCH:
+		exec_cmd_dispatch(cl, (spel_gfx_dispatch_cmd*)hdr);
+		break;
+	case SPEL_GFX_CMD_DISPATCH_INDIRECT:
+		exec_cmd_dispatch_indirect(cl, (spel_gfx_dispatch_indirect_cmd*)hdr);
+		break;
+	case SPEL_GFX_CMD_BARRIER:
+		exec_cmd_barrier(cl, (spel_gfx_barrier_cmd*)hdr);
+		break;
+	case SPEL_GFX_CMD_BIND_TEXTURE:
+		exec_cmd_bind_texture(cl, (spel_gfx_bind_texture_cmd*)hdr);
+		break;
+	case SPEL_GFX_CMD_BIND_SAMPLER:
+		exec_cmd_bind_sampler(cl, (spel_gfx_bind_sampler_cmd*)hdr);
+		break;
+	case SPEL_GFX_CMD_BIND_IMAGE:
+		exec_cmd_bind_image(cl, (spel_gfx_bind_image_cmd*)hdr);
+		break;
+	case SPEL_GFX_CMD_VIEWPORT:
+		exec_cmd_viewport(cl, (spel_gfx_viewport_cmd*)hdr);
+		break;
+	case SPEL_GFX_CMD_SCISSOR:
+		exec_cmd_scissor(cl, (spel_gfx_scissor_cmd*)hdr);
+		break;
+	case SPEL_GFX_CMD_BIND_SHADER_BUFFER:
+		exec_cmd_bind_shader_buffer(cl, (spel_gfx_bind_shader_buffer_cmd*)hdr);
+		break;
+	case SPEL_GFX_CMD_BUFFER_UPDATE:
+		exec_cmd_buffer_update(cl, (spel_gfx_buffer_update_cmd*)hdr);
+		break;
+	case SPEL_GFX_CMD_UNIFORM_UPDATE:
+		exec_cmd_uniform_update(cl, (spel_gfx_uniform_update_cmd*)hdr);
+		break;
+	case SPEL_GFX_CMD_BEGIN_RENDER_PASS:
+		exec_cmd_begin_render_pass(cl, (spel_gfx_begin_render_pass_cmd*)hdr);
+		break;
+	case SPEL_GFX_CMD_END_RENDER_PASS:
+		exec_cmd_end_render_pass(cl, (spel_gfx_end_render_pass_cmd*)hdr);
+		break;
+	case SPEL_GFX_CMD_EXECUTE:
+		// runs against this list's exec state, so it lands in the current pass
+		spel_gl_replay(cl, ((spel_gfx_execute_cmd*)hdr)->list);
+		break;
+	}
+}
+
+// sorted replay. a window is a run of binds and draws inside a pass; anything
+// else (updates, clears, viewport/scissor, pass changes) has to stay where it was
+// recorded, so it closes the window. every draw in a window remembers which bind
+// commands were live when it was recorded, the draws get radix sorted by key and
+// replayed, re-running only the binds that differ from the previous draw.
+// NULL means "never bound in this list"
+typedef struct
+{
+	spel_gfx_cmd_header* pipeline;
+	spel_gfx_cmd_header* vertex[SPEL_GFX_CMDLIST_TRACKED_STREAMS];
+	spel_gfx_cmd_header* index;
+	spel_gfx_cmd_header* textures[SPEL_GFX_CMDLIST_TRACKED_SLOTS];
+	spel_gfx_cmd_header* samplers[SPEL_GFX_CMDLIST_TRACKED_SLOTS];
+	spel_gfx_cmd_header* buffers[SPEL_GFX_CMDLIST_TRACKED_BUFFERS];
+	uint32_t buffer_count;
+} spel_gl_bind_set;
+
 typedef struct
 {
-	spel_gfx_pipeline pipeline;
+	uint64_t key;
+	spel_gfx_cmd_header* draw;
+	uint32_t binds;
+} spel_gl_sort_item;
+
+static bool spel_gl_cmd_is_draw(spel_gfx_cmd_type type)
+{
+	switch (type)
+	{
+	case SPEL_GFX_CMD_DRAW:
+	case SPEL_GFX_CMD_DRAW_INDEXED:
+	case SPEL_GFX_CMD_DRAW_INSTANCED:
+	case SPEL_GFX_CMD_DRAW_INDEXED_INSTANCED:
+	case SPEL_GFX_CMD_DRAW_INDIRECT:
+	case SPEL_GFX_CMD_DRAW_INDEXED_INDIRECT:
+		return true;
+	default:
+		return false;
+	}
+}
+
+static bool spel_gl_cmd_is_bind(spel_gfx_cmd_type type)
+{
+	switch (type)
+	{
+	case SPEL_GFX_CMD_BIND_VERTEX:
+	case SPEL_GFX_CMD_BIND_INDEX:
+	case SPEL_GFX_CMD_BIND_PIPELINE:
+	case SPEL_GFX_CMD_BIND_TEXTURE:
+	case SPEL_GFX_CMD_BIND_SAMPLER:
+	case SPEL_GFX_CMD_BIND_IMAGE:
+	case SPEL_GFX_CMD_BIND_SHADER_BUFFER:
+		return true;
+	default:
+		return false;
+	}
+}
+
+// false if the bind lands outside what the set can hold, the window then just
+// replays in order
+static bool spel_gl_bind_set_track(spel_gl_bind_set* set, spel_gfx_cmd_header* hdr)
+{
+	uint32_t slot = 0;
+
+	switch (hdr->type)
+	{
+	case SPEL_GFX_CMD_BIND_PIPELINE:
+		// same rule as the recorder, these are resolved against the pipeline
+		set->pipeline = hdr;
+		memset((void*)set->vertex, 0, sizeof(set->vertex));
+		set->index = NULL;
+		set->buffer_count = 0;
+		return true;
+	case SPEL_GFX_CMD_BIND_VERTEX:
+	{
+		uint32_t stream = ((spel_gfx_bind_vertex_cmd*)hdr)->stream;
+		if (stream >= SPEL_GFX_CMDLIST_TRACKED_STREAMS)
+		{
+			return false;
+		}
+		set->vertex[stream] = hdr;
+		return true;
+	}
+	case SPEL_GFX_CMD_BIND_INDEX:
+		set->index = hdr;
+		return true;
+	case SPEL_GFX_CMD_BIND_TEXTURE:
+		slot = ((spel_gfx_bind_texture_cmd*)hdr)->slot;
+		break;
+	case SPEL_GFX_CMD_BIND_SAMPLER:
+		slot = ((spel_gfx_bind_sampler_cmd*)hdr)->slot;
+		break;
+	case SPEL_GFX_CMD_BIND_IMAGE:
+		slot = ((spel_gfx_bind_image_cmd*)hdr)->slot;
+		break;
+	case SPEL_GFX_CMD_BIND_SHADER_BUFFER:
+	{
+		uint32_t location = ((spel_gfx_bind_shader_buffer_cmd*)hdr)->location;
+		for (uint32_t i = 0; i < set->buffer_count; i++)
+		{
+			spel_gfx_bind_shader_buffer_cmd* bound =
+				(spel_gfx_bind_shader_buffer_cmd*)set->buffers[i];
+			if (bound->location == location)
+			{
+				set->buffers[i] = hdr;
+				return true;
+			}
+		}
+
+		if (set->buffer_count == SPEL_GFX_CMDLIST_TRACKED_BUFFERS)
+		{
+			return false;
+		}
+		set->buffers[set->buffer_count++] = hdr;
+		return true;
+	}
+	default:
+		return true;
+	}
+
+	if (slot >= SPEL_GFX_CMDLIST_TRACKED_SLOTS)
+	{
+		return false;
+	}
+
+	if (hdr->type != SPEL_GFX_CMD_BIND_SAMPLER)
+	{
+		set->textures[slot] = hdr;
+	}
+	if (hdr->type != SPEL_GFX_CMD_BIND_TEXTURE)
+	{
+		set->samplers[slot] = hdr;
+	}
+	return true;
+}
+
+static inline void spel_gl_bind_apply(spel_gfx_cmdlist cl, spel_gfx_cmd_header* bind,
+									  spel_gfx_cmd_header* current, bool force)
+{
+	if (bind != NULL && (force || bind != current))
+	{
+		spel_gl_exec_cmd(cl, bind);
+	}
+}
+
+// brings gl from `applied` to `target`, running as few bind commands as possible
+static void spel_gl_bind_set_apply(spel_gfx_cmdlist cl, spel_gl_bind_set* applied,
+								   const spel_gl_bind_set* target)
+{
+	bool pipeline_changed = false;
+	if (target->pipeline != applied->pipeline && target->pipeline != NULL)
+	{
+		spel_gfx_pipeline want = ((spel_gfx_bind_pipeline_cmd*)target->pipeline)->pipeline;
+		pipeline_changed =
+			applied->pipeline == NULL ||
+			((spel_gfx_bind_pipeline_cmd*)applied->pipeline)->pipeline != want;
+
+		spel_gl_bind_apply(cl, target->pipeline, applied->pipeline, pipeline_changed);
+	}
+
+	for (uint32_t i = 0; i < SPEL_GFX_CMDLIST_TRACKED_STREAMS; i++)
+	{
+		spel_gl_bind_apply(cl, target->vertex[i], applied->vertex[i], pipeline_changed);
+	}
+	spel_gl_bind_apply(cl, target->index, applied->index, pipeline_changed);
+
+	for (uint32_t i = 0; i < SPEL_GFX_CMDLIST_TRACKED_SLOTS; i++)
+	{
+		spel_gl_bind_apply(cl, target->textures[i], applied->textures[i], false);
+
+		// a bind_image fills both, it already ran above
+		if (target->samplers[i] != target->textures[i] ||
+			target->textures[i] == applied->textures[i])
+		{
+			spel_gl_bind_apply(cl, target->samplers[i], applied->samplers[i], false);
+		}
+	}
+
+	for (uint32_t i = 0; i < target->buffer_count; i++)
+	{
+		bool bound = false;
+		for (uint32_t j = 0; j < applied->buffer_count && !pipeline_changed; j++)
+		{
+			if (applied->buffers[j] == target->buffers[i])
+			{
+				bound = true;
+				break;
+			}
+		}
+
+		if (!bound)
+		{
+			spel_gl_bind_apply(cl, target->buffers[i], NULL, true);
+		}
+	}
+
+	*applied = *target;
+}
+
+// lsd radix sort, 8 bits a pass. stable, which is what keeps blended draws in
+// order. bytes where every key agrees are skipped, most keys in a window share
+// the pass and usually the pipeline
+static spel_gl_sort_item* spel_gl_radix_sort(spel_gl_sort_item* items,
+											 spel_gl_sort_item* scratch, uint32_t count)
+{
+	uint64_t all_or = 0;
+	uint64_t all_and = ~0ULL;
+	for (uint32_t i = 0; i < count; i++)
+	{
+		all_or |= items[i].key;
+		all_and &= items[i].key;
+	}
 
-	spel_gfx_buffer index_buffer;
-	size_t index_offset;
-	GLenum index_type;
+	for (uint32_t shift = 0; shift < 64; shift += 8)
+	{
+		if ((((all_or ^ all_and) >> shift) & 0xFF) == 0)
+		{
+			continue;
+		}
 
-	spel_gfx_sampler sampler;
+		uint32_t offsets[256] = {0};
+		for (uint32_t i = 0; i < count; i++)
+		{
+			offsets[(items[i].key >> shift) & 0xFF]++;
+		}
 
-	spel_gfx_render_pass current_pass;
-	int target_height; // height of the current render target for Y-flip in
-					   // viewport/scissor
-} spel_gfx_cmdlist_gl;
+		uint32_t sum = 0;
+		for (uint32_t b = 0; b < 256; b++)
+		{
+			uint32_t n = offsets[b];
+			offsets[b] = sum;
+			sum += n;
+		}
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			scratch[offsets[(items[i].key >> shift) & 0xFF]++] = items[i];
+		}
+
+		spel_gl_sort_item* tmp = items;
+		items = scratch;
+		scratch = tmp;
+	}
+
+	return items;
+}
+
+static void spel_gl_replay_window(spel_gfx_cmdlist cl, spel_gl_bind_set* live,
+								  spel_gl_cmd_cursor cursor, uint32_t cmdCount,
+								  uint32_t drawCount)
+{
+	spel_memory_frame_marker marker = spel_memory_frame_mark();
+	size_t items_size = (size_t)drawCount * sizeof(spel_gl_sort_item) * 2;
+	size_t binds_size = (size_t)drawCount * sizeof(spel_gl_bind_set);
+
+	uint8_t* scratch = spel_memory_frame_alloc(items_size + binds_size);
+	bool scratch_owned = scratch == NULL;
+	if (scratch_owned)
+	{
+		scratch = spel_memory_malloc(items_size + binds_size, SPEL_MEM_TAG_TEMP);
+	}
+
+	spel_gl_sort_item* items = (spel_gl_sort_item*)scratch;
+	spel_gl_bind_set* binds = (spel_gl_bind_set*)(scratch + items_size);
+
+	spel_gl_bind_set applied = *live;
+	uint32_t count = 0;
+	for (uint32_t i = 0; i < cmdCount; i++)
+	{
+		spel_gfx_cmd_header* hdr = spel_gl_cursor_peek(&cursor);
+
+		if (spel_gl_cmd_is_draw(hdr->type))
+		{
+			items[count].key = ((spel_gfx_draw_cmd*)hdr)->sort_key;
+			items[count].draw = hdr;
+			items[count].binds = count;
+			binds[count] = *live;
+			count++;
+		}
+		else
+		{
+			spel_gl_bind_set_track(live, hdr);
+		}
+
+		spel_gl_cursor_advance(&cursor, hdr);
+	}
+
+	spel_gl_sort_item* sorted = spel_gl_radix_sort(items, items + drawCount, count);
+	for (uint32_t i = 0; i < count; i++)
+	{
+		spel_gl_bind_set_apply(cl, &applied, &binds[sorted[i].binds]);
+		spel_gl_exec_cmd(cl, sorted[i].draw);
+	}
+
+	// leave gl the way in-order replay would have, including binds recorded
+	// after the last draw
+	spel_gl_bind_set_apply(cl, &applied, live);
+
+	if (scratch_owned)
+	{
+		spel_memory_free(scratch);
+	}
+	spel_memory_frame_rewind(marker);
+}
+
+static void spel_gl_replay_sorted(spel_gfx_cmdlist cl, spel_gfx_cmdlist src)
+{
+	spel_gl_bind_set live = {0};
+	bool in_pass = ((spel_gfx_cmdlist_gl*)cl->data)->current_pass != NULL;
+
+	spel_gl_cmd_cursor cursor = spel_gl_cursor_begin(src);
+	spel_gfx_cmd_header* hdr;
+	while ((hdr = spel_gl_cursor_peek(&cursor)) != NULL)
+	{
+		if (!in_pass || !(spel_gl_cmd_is_bind(hdr->type) || spel_gl_cmd_is_draw(hdr->type)))
+		{
+			if (hdr->type == SPEL_GFX_CMD_BEGIN_RENDER_PASS)
+			{
+				in_pass = true;
+			}
+			else if (hdr->type == SPEL_GFX_CMD_END_RENDER_PASS)
+			{
+				in_pass = false;
+			}
+
+			spel_gl_bind_set_track(&live, hdr);
+			spel_gl_exec_cmd(cl, hdr);
+			spel_gl_cursor_advance(&cursor, hdr);
+
+			// a secondary binds whatever it likes, nothing in `live` is current anymore
+			if (hdr->type == SPEL_GFX_CMD_EXECUTE)
+			{
+				memset((void*)&live, 0, sizeof(live));
+			}
+			continue;
+		}
+
+		// find where the window ends and whether everything in it can be tracked
+		spel_gl_bind_set probe = live;
+		spel_gl_cmd_cursor window = cursor;
+		uint32_t cmds = 0;
+		uint32_t draws = 0;
+		bool sortable = true;
+		spel_gfx_cmd_header* w;
+		while ((w = spel_gl_cursor_peek(&window)) != NULL)
+		{
+			if (spel_gl_cmd_is_draw(w->type))
+			{
+				draws++;
+			}
+			else if (spel_gl_cmd_is_bind(w->type))
+			{
+				sortable = spel_gl_bind_set_track(&probe, w) && sortable;
+			}
+			else
+			{
+				break;
+			}
+
+			cmds++;
+			spel_gl_cursor_advance(&window, w);
+		}
+
+		if (sortable && draws > 1)
+		{
+			spel_gl_replay_window(cl, &live, cursor, cmds, draws);
+		}
+		else
+		{
+			spel_gl_cmd_cursor it = cursor;
+			for (uint32_t i = 0; i < cmds; i++)
+			{
+				spel_gfx_cmd_header* cmd = spel_gl_cursor_peek(&it);
+				spel_gl_bind_set_track(&live, cmd);
+				spel_gl_exec_cmd(cl, cmd);
+				spel_gl_cursor_advance(&it, cmd);
+			}
+		}
+
+		cursor = window;
+	}
+}
+
+// `cl` owns the exec state (pipeline, pass, index buffer), `src` owns the
+// commands. they're the same list except when a primary runs a secondary
+static void spel_gl_replay(spel_gfx_cmdlist cl, spel_gfx_cmdlist src)
+{
+	if (src->sorted)
+	{
+		spel_gl_replay_sorted(cl, src);
+		return;
+	}
+
+	spel_gl_cmd_cursor cursor = spel_gl_cursor_begin(src);
+	spel_gfx_cmd_header* hdr;
+	while ((hdr = spel_gl_cursor_peek(&cursor)) != NULL)
+	{
+		spel_gl_exec_cmd(cl, hdr);
+		spel_gl_cursor_advance(&cursor, hdr);
+	}
+}
+
+static void spel_gl_chunk_lock(spel_gfx_context_gl* gl)
+{
+	while (atomic_flag_test_and_set_explicit(&gl->chunk_lock, memory_order_acquire))
+	{
+	}
+}
+
+static void spel_gl_chunk_unlock(spel_gfx_context_gl* gl)
+{
+	atomic_flag_clear_explicit(&gl->chunk_lock, memory_order_release);
+}
+
+// secondaries record on worker threads, so the shared chunk pool sits behind a
+// spinlock. it's only taken when a list needs a new chunk or gives its extras back
+static spel_gfx_cmd_chunk* spel_gl_chunk_acquire(spel_gfx_cmdlist cl, size_t size)
+{
+	spel_gfx_context_gl* gl = (spel_gfx_context_gl*)cl->ctx->data;
+	spel_gfx_cmd_chunk* chunk = NULL;
+
+	if (size <= spel_cmdlist_chunk_size - spel_cmdlist_chunk_header)
+	{
+		spel_gl_chunk_lock(gl);
+		chunk = spel_memory_pool_alloc(&gl->pools.cmd_chunks);
+		spel_gl_chunk_unlock(gl);
+
+		if (chunk)
+		{
+			chunk->capacity = spel_cmdlist_chunk_size - spel_cmdlist_chunk_header;
+			chunk->large = false;
+		}
+	}
+	else
+	{
+		// big uploads tend to come back every frame at about the same size
+		for (spel_gfx_cmd_chunk** it = &cl->spare_large; *it; it = &(*it)->next)
+		{
+			if ((*it)->capacity >= size)
+			{
+				chunk = *it;
+				*it = chunk->next;
+				break;
+			}
+		}
+
+		if (!chunk)
+		{
+			chunk = spel_memory_malloc(spel_cmdlist_chunk_header + size, SPEL_MEM_TAG_GFX);
+			if (chunk)
+			{
+				chunk->capacity = (uint32_t)size;
+				chunk->large = true;
+			}
+		}
+	}
+
+	if (!chunk)
+	{
+		return NULL;
+	}
+
+	chunk->next = NULL;
+	chunk->used = 0;
+	cl->chunk_count++;
+	return chunk;
+}
 
 spel_gfx_cmdlist spel_gfx_cmdlist_create_gl(spel_gfx_context ctx)
 {
-	spel_gfx_cmdlist cl =
-		(spel_gfx_cmdlist)spel_memory_malloc(sizeof(*cl), SPEL_MEM_TAG_GFX);
-	cl->capacity = (int)spel_cmdlist_default_size;
+	spel_gfx_cmdlist_slot_gl* slot =
+		spel_memory_pool_alloc(&((spel_gfx_context_gl*)ctx->data)->pools.cmdlists);
+	if (!slot)
+	{
+		spel_error(SPEL_ERR_OOM, "failed to allocate command list");
+		return NULL;
+	}
+
+	// chunks are picked up on the first command
+	spel_gfx_cmdlist cl = &slot->handle;
 	cl->offset = 0;
 	cl->ctx = ctx;
-	cl->buffer = spel_memory_malloc(cl->capacity, SPEL_MEM_TAG_GFX);
 
-	spel_gfx_cmdlist_gl* data = (spel_gfx_cmdlist_gl*)spel_memory_malloc(
-		sizeof(spel_gfx_cmdlist_gl), SPEL_MEM_TAG_GFX);
+	spel_gfx_cmdlist_gl* data = &slot->gl;
 	cl->data = data;
 
 	cl->dirty_buffer_cap = 8;
@@ -75,35 +673,126 @@ spel_gfx_cmdlist spel_gfx_cmdlist_create_gl(spel_gfx_context ctx)
 
 void spel_gfx_cmdlist_destroy_gl(spel_gfx_cmdlist cl)
 {
+	spel_gfx_cmdlist_reset_gl(cl);
+
+	spel_gfx_context_gl* gl = (spel_gfx_context_gl*)cl->ctx->data;
+	if (cl->head)
+	{
+		spel_gl_chunk_lock(gl);
+		spel_memory_pool_free(&gl->pools.cmd_chunks, cl->head);
+		spel_gl_chunk_unlock(gl);
+	}
+
+	while (cl->spare_large)
+	{
+		spel_gfx_cmd_chunk* next = cl->spare_large->next;
+		spel_memory_free(cl->spare_large);
+		cl->spare_large = next;
+	}
+
 	spel_memory_free(cl->dirty_buffers);
-	spel_memory_free(cl->data);
-	spel_memory_free(cl->buffer);
-	spel_memory_free(cl);
+	spel_memory_pool_free(&gl->pools.cmdlists, cl);
+}
+
+// keeps the first pooled chunk so a list that fits in one never touches the pool
+// again, the rest go back for other lists to use. large chunks used this frame
+// become the spares for the next one, spares nobody reused are freed
+void spel_gfx_cmdlist_reset_gl(spel_gfx_cmdlist cl)
+{
+	if (cl->chunk_count > cl->chunk_peak)
+	{
+		cl->chunk_peak = cl->chunk_count;
+	}
+
+	while (cl->spare_large)
+	{
+		spel_gfx_cmd_chunk* next = cl->spare_large->next;
+		spel_memory_free(cl->spare_large);
+		cl->spare_large = next;
+	}
+
+	spel_gfx_context_gl* gl = (spel_gfx_context_gl*)cl->ctx->data;
+	spel_gfx_cmd_chunk* keep = NULL;
+	spel_gfx_cmd_chunk* chunk = cl->head;
+	bool locked = false;
+
+	while (chunk)
+	{
+		spel_gfx_cmd_chunk* next = chunk->next;
+
+		if (chunk->large)
+		{
+			chunk->next = cl->spare_large;
+			cl->spare_large = chunk;
+		}
+		else if (!keep)
+		{
+			keep = chunk;
+		}
+		else
+		{
+			if (!locked)
+			{
+				spel_gl_chunk_lock(gl);
+				locked = true;
+			}
+			spel_memory_pool_free(&gl->pools.cmd_chunks, chunk);
+		}
+
+		chunk = next;
+	}
+
+	if (locked)
+	{
+		spel_gl_chunk_unlock(gl);
+	}
+
+	if (keep)
+	{
+		keep->next = NULL;
+		keep->used = 0;
+	}
+
+	cl->head = keep;
+	cl->tail = keep;
+	cl->chunk_count = keep ? 1 : 0;
+	cl->offset = 0;
 }
 
 void* spel_gfx_cmdlist_alloc_gl(spel_gfx_cmdlist cl, size_t size, size_t align)
 {
 	const size_t MAX_ALIGN = _Alignof(max_align_t);
 
-	uint64_t aligned = (cl->offset + (align - 1)) & ~(align - 1);
-	uint64_t end = aligned + size;
-	uint64_t padded_end = (end + (MAX_ALIGN - 1)) & ~(MAX_ALIGN - 1);
+	// every command is padded to max_align_t, so each one starts as aligned as the
+	// chunk data itself and `offset - start` is exactly the command's size
+	spel_assert(align <= MAX_ALIGN, "command alignment %zu is more than a chunk gives",
+				align);
+	uint64_t padded = (size + (MAX_ALIGN - 1)) & ~(MAX_ALIGN - 1);
 
-	while (padded_end > cl->capacity)
+	spel_gfx_cmd_chunk* chunk = cl->tail;
+	if (!chunk || chunk->used + padded > chunk->capacity)
 	{
-		cl->capacity *= 2;
-		void* new_buffer =
-			spel_memory_realloc(cl->buffer, cl->capacity, SPEL_MEM_TAG_GFX);
-		if (new_buffer == NULL)
+		chunk = spel_gl_chunk_acquire(cl, padded);
+		if (!chunk)
 		{
-			spel_error(SPEL_ERR_OOM, "out of memory?");
+			spel_error(SPEL_ERR_OOM, "failed to allocate a command list chunk");
 			return NULL;
 		}
-		cl->buffer = new_buffer;
+
+		if (cl->tail)
+		{
+			cl->tail->next = chunk;
+		}
+		else
+		{
+			cl->head = chunk;
+		}
+		cl->tail = chunk;
 	}
 
-	void* ptr = cl->buffer + aligned;
-	cl->offset = padded_end;
+	void* ptr = spel_gfx_cmd_chunk_data(chunk) + chunk->used;
+	chunk->used += (uint32_t)padded;
+	cl->offset += padded;
 	return ptr;
 }
 
@@ -111,17 +800,23 @@ void spel_gfx_cmdlist_submit_gl(spel_gfx_cmdlist cl)
 {
 	if (spel.window.occluded)
 	{
-		cl->offset = 0;
+		if (!cl->bundle)
+		{
+			spel_gfx_cmdlist_reset_gl(cl);
+		}
 		cl->dirty_buffer_count = 0;
 		return;
 	}
 
-	GLint prev_program = 0;
-	GLint prev_vao = 0;
-	GLint prev_fbo = 0;
-	glGetIntegerv(GL_CURRENT_PROGRAM, &prev_program);
-	glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &prev_vao);
-	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &prev_fbo);
+	spel_gfx_context_gl* gl = (spel_gfx_context_gl*)cl->ctx->data;
+	spel_gl_state_validate(gl, "cmdlist submit");
+
+	// immediate updates made while this was recorded have to land before it runs
+	spel_gl_upload_flush(cl->ctx);
+
+	GLuint prev_program = gl->bound.program;
+	GLuint prev_vao = gl->bound.vao;
+	GLuint prev_fbo = gl->bound.fbo;
 
 	if (((spel_gfx_cmdlist_gl*)cl->data)->current_pass != NULL)
 	{
@@ -133,92 +828,32 @@ void spel_gfx_cmdlist_submit_gl(spel_gfx_cmdlist cl)
 		spel_gfx_buffer_flush_gl(cl->dirty_buffers[i], 0, 0);
 	}
 
-	uint8_t* ptr = cl->buffer;
-	while (ptr < cl->buffer + cl->offset)
-	{
-		spel_gfx_cmd_header* hdr = (spel_gfx_cmd_header*)ptr;
-		uint64_t remaining = (uint64_t)((cl->buffer + cl->offset) - ptr);
+	// handles were checked when the commands were recorded, replay doesn't look
+	// at them again
+	spel_gl_replay(cl, cl);
 
-		if (hdr->size == 0 || hdr->size > remaining)
-		{
-			spel_error(SPEL_ERR_INVALID_STATE,
-					   "invalid command header: type %d size %llu",
-					   hdr->type, (unsigned long long)hdr->size);
-			break;
-		}
-
-		uint8_t* next = ptr + hdr->size;
-
-		switch (hdr->type)
-		{
-		case SPEL_GFX_CMD_CLEAR:
-			exec_cmd_clear(cl, (spel_gfx_clear_cmd*)ptr);
-			break;
-		case SPEL_GFX_CMD_BIND_VERTEX:
-			exec_cmd_bind_vertex(cl, (spel_gfx_bind_vertex_cmd*)ptr);
-			break;
-		case SPEL_GFX_CMD_BIND_INDEX:
-			exec_cmd_bind_index(cl, (spel_gfx_bind_index_cmd*)ptr);
-			break;
-		case SPEL_GFX_CMD_BIND_PIPELINE:
-			exec_cmd_bind_pipeline(cl, (spel_gfx_bind_pipeline_cmd*)ptr);
-			break;
-		case SPEL_GFX_CMD_DRAW:
-			exec_cmd_draw(cl, (spel_gfx_draw_cmd*)ptr);
-			break;
-		case SPEL_GFX_CMD_DRAW_INDEXED:
-			exec_cmd_draw_indexed(cl, (spel_gfx_draw_indexed_cmd*)ptr);
-			break;
-		case SPEL_GFX_CMD_BIND_TEXTURE:
-			exec_cmd_bind_texture(cl, (spel_gfx_bind_texture_cmd*)ptr);
-			break;
-		case SPEL_GFX_CMD_BIND_SAMPLER:
-			exec_cmd_bind_sampler(cl, (spel_gfx_bind_sampler_cmd*)ptr);
-			break;
-		case SPEL_GFX_CMD_BIND_IMAGE:
-			exec_cmd_bind_image(cl, (spel_gfx_bind_image_cmd*)ptr);
-			break;
-		case SPEL_GFX_CMD_VIEWPORT:
-			exec_cmd_viewport(cl, (spel_gfx_viewport_cmd*)ptr);
-			break;
-		case SPEL_GFX_CMD_SCISSOR:
-			exec_cmd_scissor(cl, (spel_gfx_scissor_cmd*)ptr);
-			break;
-		case SPEL_GFX_CMD_BIND_SHADER_BUFFER:
-			exec_cmd_bind_shader_buffer(cl, (spel_gfx_bind_shader_buffer_cmd*)ptr);
-			break;
-		case SPEL_GFX_CMD_BUFFER_UPDATE:
-			exec_cmd_buffer_update(cl, (spel_gfx_buffer_update_cmd*)ptr);
-			break;
-		case SPEL_GFX_CMD_UNIFORM_UPDATE:
-			exec_cmd_uniform_update(cl, (spel_gfx_uniform_update_cmd*)ptr);
-			break;
-		case SPEL_GFX_CMD_BEGIN_RENDER_PASS:
-			exec_cmd_begin_render_pass(cl, (spel_gfx_begin_render_pass_cmd*)ptr);
-			break;
-		case SPEL_GFX_CMD_END_RENDER_PASS:
-			exec_cmd_end_render_pass(cl, (spel_gfx_end_render_pass_cmd*)ptr);
-			break;
-		}
-
-		ptr = next;
+	if (!cl->bundle)
+	{
+		spel_gfx_cmdlist_reset_gl(cl);
 	}
-
-	cl->offset = 0;
 	cl->dirty_buffer_count = 0;
 
 	memset(cl->dirty_buffers, 0, cl->dirty_buffer_count * sizeof(*cl->dirty_buffers));
 
 	// Restore captured state.
-	if (prev_program != 0)
+	if (prev_program != 0 && prev_program != gl->bound.program)
 	{
-		glUseProgram((GLuint)prev_program);
+		spel_gl_use_program(gl, prev_program);
+		gl->pipeline = NULL; // its program isn't the current one anymore
 	}
-	if (prev_vao != 0)
+	if (prev_vao != 0 && prev_vao != gl->bound.vao)
 	{
-		glBindVertexArray((GLuint)prev_vao);
+		spel_gl_bind_vao(gl, prev_vao);
+		gl->pipeline = NULL;
 	}
-	glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)prev_fbo);
+	spel_gl_bind_fbo(gl, prev_fbo);
+
+	spel_gl_state_validate(gl, "cmdlist submit end");
 }
 
 void exec_cmd_clear(spel_gfx_cmdlist cl, spel_gfx_clear_cmd* cmd)
@@ -230,12 +865,6 @@ void exec_cmd_clear(spel_gfx_cmdlist cl, spel_gfx_clear_cmd* cmd)
 
 void exec_cmd_bind_vertex(spel_gfx_cmdlist cl, spel_gfx_bind_vertex_cmd* cmd)
 {
-	if (cmd->buf->type != SPEL_GFX_BUFFER_VERTEX)
-	{
-		spel_warn("buffer type does not correspond to binding cmd (vertex). this is "
-				"allowed, but discouraged");
-	}
-
 	if (((spel_gfx_cmdlist_gl*)cl->data)->pipeline == NULL)
 	{
 		spel_error(SPEL_ERR_INVALID_STATE,
@@ -246,112 +875,205 @@ void exec_cmd_bind_vertex(spel_gfx_cmdlist cl, spel_gfx_bind_vertex_cmd* cmd)
 	spel_gfx_pipeline_gl* pipeline =
 		((spel_gfx_pipeline_gl*)((spel_gfx_cmdlist_gl*)cl->data)->pipeline->data);
 
+	// compute pipelines have no vertex layout, the recorder can miss one bound
+	// by an executed secondary
+	if (pipeline->strides == NULL)
+	{
+		spel_error(SPEL_ERR_INVALID_STATE,
+				   "cannot bind a vertex buffer while a compute pipeline is bound");
+		return;
+	}
+
 	glVertexArrayVertexBuffer(pipeline->vao, cmd->stream, *(GLuint*)cmd->buf->data,
 							  (long)cmd->offset, pipeline->strides[cmd->stream]);
 }
 
-void exec_cmd_bind_pipeline(spel_gfx_cmdlist cl, spel_gfx_bind_pipeline_cmd* cmd)
+// true when the call has to go out, counts it either way
+static inline bool spel_gl_state_differs(spel_gfx_context ctx, bool force, bool differs)
 {
-	if (((spel_gfx_context_gl*)cl->data)->pipeline == cmd->pipeline)
+	if (force || differs)
 	{
-		return;
+		ctx->stats.state_calls++;
+		return true;
 	}
 
-	((spel_gfx_context_gl*)cl->data)->pipeline = cmd->pipeline;
+	ctx->stats.state_calls_skipped++;
+	return false;
+}
 
-	((spel_gfx_cmdlist_gl*)cl->data)->pipeline =
-		cmd->pipeline;
-	spel_gfx_pipeline_gl* p = (spel_gfx_pipeline_gl*)cmd->pipeline->data;
-	
-	glUseProgram(p->program);
-	glBindVertexArray(p->vao);
+static inline void spel_gl_state_cap(spel_gfx_context ctx, bool force, bool* cached,
+									 bool value, GLenum cap)
+{
+	if (!spel_gl_state_differs(ctx, force, *cached != value))
+	{
+		return;
+	}
 
-	if (p->depth_state.test)
+	if (value)
 	{
-		glEnable(GL_DEPTH_TEST);
+		glEnable(cap);
 	}
 	else
 	{
-		glDisable(GL_DEPTH_TEST);
+		glDisable(cap);
 	}
+	*cached = value;
+}
 
-	glDepthMask((int)p->depth_state.write ? GL_TRUE : GL_FALSE);
-	glDepthFunc(p->depth_state.func);
+void exec_cmd_bind_pipeline(spel_gfx_cmdlist cl, spel_gfx_bind_pipeline_cmd* cmd)
+{
+	spel_gfx_context_gl* gl = (spel_gfx_context_gl*)cl->ctx->data;
+
+	// the list has to know its pipeline even when gl already has it bound
+	((spel_gfx_cmdlist_gl*)cl->data)->pipeline = cmd->pipeline;
 
-	if (p->depth_state.clamp)
+	if (gl->pipeline == cmd->pipeline)
 	{
-		glEnable(GL_DEPTH_CLAMP);
+		return;
 	}
-	else
+
+	gl->pipeline = cmd->pipeline;
+	spel_gfx_pipeline_gl* p = (spel_gfx_pipeline_gl*)cmd->pipeline->data;
+
+	// a precompiled program gets its link checked the first time it's used,
+	// waiting on the driver if it's still going
+	if (p->pending)
 	{
-		glDisable(GL_DEPTH_CLAMP);
+		spel_gl_pipeline_resolve(cmd->pipeline);
 	}
 
-	if (p->stencil_state.test)
+	// compute only needs its program, render state stays for whatever draws next
+	if (cmd->pipeline->type == SPEL_GFX_PIPELINE_COMPUTE)
 	{
-		glEnable(GL_STENCIL_TEST);
+		spel_gl_use_program(gl, p->program);
+		return;
+	}
 
-		glStencilFunc(p->stencil_state.func, (int)p->stencil_state.reference,
-					  p->stencil_state.read_mask);
+	spel_gl_render_state* s = &gl->state;
+	spel_gfx_context ctx = cl->ctx;
+	// the first bind (or one after the shadow got resynced) sets everything
+	bool force = !s->valid;
 
-		glStencilOp(p->stencil_state.fail_op, p->stencil_state.depth_op,
-					p->stencil_state.pass_op);
+	ctx->stats.pipeline_binds++;
 
-		glStencilMask(p->stencil_state.write_mask);
-	}
-	else
+	spel_gl_use_program(gl, p->program);
+	spel_gl_bind_vao(gl, p->vao);
+
+	spel_gl_state_cap(ctx, force, &s->depth_test, p->depth_state.test, GL_DEPTH_TEST);
+
+	if (spel_gl_state_differs(ctx, force, s->depth_write != p->depth_state.write))
 	{
-		glDisable(GL_STENCIL_TEST);
+		glDepthMask(p->depth_state.write ? GL_TRUE : GL_FALSE);
+		s->depth_write = p->depth_state.write;
 	}
 
-	if (p->blend_state.enabled)
+	if (spel_gl_state_differs(ctx, force, s->depth_func != p->depth_state.func))
 	{
-		glEnable(GL_BLEND);
+		glDepthFunc(p->depth_state.func);
+		s->depth_func = p->depth_state.func;
+	}
 
-		glBlendFuncSeparate(p->blend_state.src_rgb, p->blend_state.dst_rgb,
-							p->blend_state.src_a, p->blend_state.dst_a);
+	spel_gl_state_cap(ctx, force, &s->depth_clamp, p->depth_state.clamp, GL_DEPTH_CLAMP);
+	spel_gl_state_cap(ctx, force, &s->stencil_test, p->stencil_state.test,
+					  GL_STENCIL_TEST);
 
-		glBlendEquationSeparate(p->blend_state.op_rgb, p->blend_state.op_a);
-	}
-	else
+	if (p->stencil_state.test)
 	{
-		glDisable(GL_BLEND);
+		bool force_ops = force || !s->stencil_set;
+		if (spel_gl_state_differs(ctx, force_ops,
+								  s->stencil_func != p->stencil_state.func ||
+									  s->stencil_ref != (GLint)p->stencil_state.reference ||
+									  s->stencil_read_mask != p->stencil_state.read_mask))
+		{
+			glStencilFunc(p->stencil_state.func, (int)p->stencil_state.reference,
+						  p->stencil_state.read_mask);
+			s->stencil_func = p->stencil_state.func;
+			s->stencil_ref = (GLint)p->stencil_state.reference;
+			s->stencil_read_mask = p->stencil_state.read_mask;
+		}
+
+		if (spel_gl_state_differs(ctx, force_ops,
+								  s->stencil_fail_op != p->stencil_state.fail_op ||
+									  s->stencil_depth_op != p->stencil_state.depth_op ||
+									  s->stencil_pass_op != p->stencil_state.pass_op))
+		{
+			glStencilOp(p->stencil_state.fail_op, p->stencil_state.depth_op,
+						p->stencil_state.pass_op);
+			s->stencil_fail_op = p->stencil_state.fail_op;
+			s->stencil_depth_op = p->stencil_state.depth_op;
+			s->stencil_pass_op = p->stencil_state.pass_op;
+		}
+
+		if (spel_gl_state_differs(ctx, force_ops,
+								  s->stencil_write_mask != p->stencil_state.write_mask))
+		{
+			glStencilMask(p->stencil_state.write_mask);
+			s->stencil_write_mask = p->stencil_state.write_mask;
+		}
+		s->stencil_set = true;
 	}
 
-	glColorMask(
-		(p->blend_state.write_mask & 0x1) != 0, (p->blend_state.write_mask & 0x2) != 0,
-		(p->blend_state.write_mask & 0x4) != 0, (p->blend_state.write_mask & 0x8) != 0);
+	spel_gl_state_cap(ctx, force, &s->blend, p->blend_state.enabled, GL_BLEND);
 
-	if (p->topology.cull_mode != 0)
+	if (p->blend_state.enabled)
 	{
-		glEnable(GL_CULL_FACE);
-		glCullFace(p->topology.cull_mode);
+		bool force_ops = force || !s->blend_set;
+		if (spel_gl_state_differs(ctx, force_ops,
+								  s->blend_src_rgb != p->blend_state.src_rgb ||
+									  s->blend_dst_rgb != p->blend_state.dst_rgb ||
+									  s->blend_src_a != p->blend_state.src_a ||
+									  s->blend_dst_a != p->blend_state.dst_a))
+		{
+			glBlendFuncSeparate(p->blend_state.src_rgb, p->blend_state.dst_rgb,
+								p->blend_state.src_a, p->blend_state.dst_a);
+			s->blend_src_rgb = p->blend_state.src_rgb;
+			s->blend_dst_rgb = p->blend_state.dst_rgb;
+			s->blend_src_a = p->blend_state.src_a;
+			s->blend_dst_a = p->blend_state.dst_a;
+		}
+
+		if (spel_gl_state_differs(ctx, force_ops,
+								  s->blend_op_rgb != p->blend_state.op_rgb ||
+									  s->blend_op_a != p->blend_state.op_a))
+		{
+			glBlendEquationSeparate(p->blend_state.op_rgb, p->blend_state.op_a);
+			s->blend_op_rgb = p->blend_state.op_rgb;
+			s->blend_op_a = p->blend_state.op_a;
+		}
+		s->blend_set = true;
 	}
-	else
+
+	if (spel_gl_state_differs(ctx, force, s->color_mask != p->blend_state.write_mask))
 	{
-		glDisable(GL_CULL_FACE);
+		glColorMask((p->blend_state.write_mask & 0x1) != 0,
+					(p->blend_state.write_mask & 0x2) != 0,
+					(p->blend_state.write_mask & 0x4) != 0,
+					(p->blend_state.write_mask & 0x8) != 0);
+		s->color_mask = p->blend_state.write_mask;
 	}
 
-	if (p->scissor_test)
+	spel_gl_state_cap(ctx, force, &s->cull, p->topology.cull_mode != 0, GL_CULL_FACE);
+
+	if (p->topology.cull_mode != 0 &&
+		spel_gl_state_differs(ctx, force, s->cull_mode != p->topology.cull_mode))
 	{
-		glEnable(GL_SCISSOR_TEST);
+		glCullFace(p->topology.cull_mode);
+		s->cull_mode = p->topology.cull_mode;
 	}
-	else
+
+	spel_gl_state_cap(ctx, force, &s->scissor_test, p->scissor_test, GL_SCISSOR_TEST);
+
+	if (spel_gl_state_differs(ctx, force, s->front_face != p->topology.winding))
 	{
-		glDisable(GL_SCISSOR_TEST);
+		glFrontFace(p->topology.winding);
+		s->front_face = p->topology.winding;
 	}
 
-	glFrontFace(p->topology.winding);
+	s->valid = true;
 }
 
 void exec_cmd_bind_index(spel_gfx_cmdlist cl, spel_gfx_bind_index_cmd* cmd)
 {
-	if (cmd->buf->type != SPEL_GFX_BUFFER_INDEX)
-	{
-		spel_warn("buffer type does not correspond to binding cmd (index). this is "
-				"allowed, but discouraged");
-	}
-
 	((spel_gfx_cmdlist_gl*)cl->data)->index_buffer = cmd->buf;
 	((spel_gfx_cmdlist_gl*)cl->data)->index_offset = cmd->offset;
 	((spel_gfx_cmdlist_gl*)cl->data)->index_type =
@@ -396,6 +1118,157 @@ void exec_cmd_draw_indexed(spel_gfx_cmdlist cl, spel_gfx_draw_indexed_cmd* cmd)
 							 exec->index_type, (void*)byte_offset, cmd->vertex_offset);
 }
 
+void exec_cmd_draw_instanced(spel_gfx_cmdlist cl, spel_gfx_draw_instanced_cmd* cmd)
+{
+	spel_gfx_pipeline_gl* p =
+		(spel_gfx_pipeline_gl*)((spel_gfx_cmdlist_gl*)cl->data)->pipeline->data;
+
+	glDrawArraysInstancedBaseInstance(p->topology.primitives, (int)cmd->first_vertex,
+									  (int)cmd->vertex_count, (int)cmd->instance_count,
+									  cmd->first_instance);
+}
+
+void exec_cmd_draw_indexed_instanced(spel_gfx_cmdlist cl,
+									 spel_gfx_draw_indexed_instanced_cmd* cmd)
+{
+	spel_gfx_cmdlist_gl* exec = (spel_gfx_cmdlist_gl*)cl->data;
+	spel_gfx_pipeline_gl* p = (spel_gfx_pipeline_gl*)exec->pipeline->data;
+
+	size_t byte_offset =
+		exec->index_offset + ((size_t)cmd->first_index * spel_gl_index_size(exec->index_type));
+
+	glDrawElementsInstancedBaseVertexBaseInstance(
+		p->topology.primitives, (int)cmd->index_count, exec->index_type,
+		(void*)byte_offset, (int)cmd->instance_count, cmd->vertex_offset,
+		cmd->first_instance);
+}
+
+void exec_cmd_draw_indirect(spel_gfx_cmdlist cl, spel_gfx_draw_indirect_cmd* cmd)
+{
+	spel_gfx_pipeline_gl* p =
+		(spel_gfx_pipeline_gl*)((spel_gfx_cmdlist_gl*)cl->data)->pipeline->data;
+
+	spel_gl_bind_indirect((spel_gfx_context_gl*)cl->ctx->data,
+						  ((spel_gfx_gl_buffer*)cmd->buf->data)->buffer);
+
+	if (cmd->draw_count == 1)
+	{
+		glDrawArraysIndirect(p->topology.primitives, (void*)cmd->offset);
+		return;
+	}
+
+	glMultiDrawArraysIndirect(p->topology.primitives, (void*)cmd->offset,
+							  (int)cmd->draw_count, (int)cmd->stride);
+}
+
+void exec_cmd_draw_indexed_indirect(spel_gfx_cmdlist cl, spel_gfx_draw_indirect_cmd* cmd)
+{
+	spel_gfx_cmdlist_gl* exec = (spel_gfx_cmdlist_gl*)cl->data;
+	spel_gfx_pipeline_gl* p = (spel_gfx_pipeline_gl*)exec->pipeline->data;
+
+	spel_gl_bind_indirect((spel_gfx_context_gl*)cl->ctx->data,
+						  ((spel_gfx_gl_buffer*)cmd->buf->data)->buffer);
+
+	if (cmd->draw_count == 1)
+	{
+		glDrawElementsIndirect(p->topology.primitives, exec->index_type,
+							   (void*)cmd->offset);
+		return;
+	}
+
+	glMultiDrawElementsIndirect(p->topology.primitives, exec->index_type,
+								(void*)cmd->offset, (int)cmd->draw_count,
+								(int)cmd->stride);
+}
+
+static inline bool spel_gl_compute_bound(spel_gfx_cmdlist cl)
+{
+	spel_gfx_pipeline pipeline = ((spel_gfx_cmdlist_gl*)cl->data)->pipeline;
+	if (pipeline == NULL || pipeline->type != SPEL_GFX_PIPELINE_COMPUTE)
+	{
+		spel_error(SPEL_ERR_INVALID_STATE,
+				   "you need to bind a compute pipeline before dispatching");
+		return false;
+	}
+
+	return true;
+}
+
+void exec_cmd_dispatch(spel_gfx_cmdlist cl, spel_gfx_dispatch_cmd* cmd)
+{
+	if (!spel_gl_compute_bound(cl))
+	{
+		return;
+	}
+
+	glDispatchCompute(cmd->groups_x, cmd->groups_y, cmd->groups_z);
+}
+
+void exec_cmd_dispatch_indirect(spel_gfx_cmdlist cl, spel_gfx_dispatch_indirect_cmd* cmd)
+{
+	if (!spel_gl_compute_bound(cl))
+	{
+		return;
+	}
+
+	spel_gl_bind_dispatch_indirect((spel_gfx_context_gl*)cl->ctx->data,
+								   ((spel_gfx_gl_buffer*)cmd->buf->data)->buffer);
+	glDispatchComputeIndirect((GLintptr)cmd->offset);
+}
+
+static GLbitfield spel_gl_barrier_bits(spel_gfx_barrier barriers)
+{
+	if (barriers == spel_gfx_barrier_all)
+	{
+		return GL_ALL_BARRIER_BITS;
+	}
+
+	GLbitfield bits = 0;
+	if (barriers & spel_gfx_barrier_vertex)
+	{
+		bits |= GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT;
+	}
+	if (barriers & spel_gfx_barrier_index)
+	{
+		bits |= GL_ELEMENT_ARRAY_BARRIER_BIT;
+	}
+	if (barriers & spel_gfx_barrier_uniform)
+	{
+		bits |= GL_UNIFORM_BARRIER_BIT;
+	}
+	if (barriers & spel_gfx_barrier_storage)
+	{
+		bits |= GL_SHADER_STORAGE_BARRIER_BIT;
+	}
+	if (barriers & spel_gfx_barrier_texture)
+	{
+		bits |= GL_TEXTURE_FETCH_BARRIER_BIT;
+	}
+	if (barriers & spel_gfx_barrier_image)
+	{
+		bits |= GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+	}
+	if (barriers & spel_gfx_barrier_indirect)
+	{
+		bits |= GL_COMMAND_BARRIER_BIT;
+	}
+	if (barriers & spel_gfx_barrier_buffer_update)
+	{
+		bits |= GL_BUFFER_UPDATE_BARRIER_BIT;
+	}
+	if (barriers & spel_gfx_barrier_framebuffer)
+	{
+		bits |= GL_FRAMEBUFFER_BARRIER_BIT;
+	}
+
+	return bits;
+}
+
+void exec_cmd_barrier(spel_gfx_cmdlist cl, spel_gfx_barrier_cmd* cmd)
+{
+	glMemoryBarrier(spel_gl_barrier_bits(cmd->barriers));
+}
+
 void exec_cmd_bind_texture(spel_gfx_cmdlist cl, spel_gfx_bind_texture_cmd* cmd)
 {
 	glBindTextureUnit(cmd->slot, *(GLuint*)cmd->texture->data);
@@ -429,35 +1302,48 @@ void exec_cmd_scissor(spel_gfx_cmdlist cl, spel_gfx_scissor_cmd* cmd)
 void exec_cmd_bind_shader_buffer(spel_gfx_cmdlist cl,
 								 spel_gfx_bind_shader_buffer_cmd* cmd)
 {
-	uint32_t binding = -1;
-
 	spel_gfx_pipeline pipeline = ((spel_gfx_cmdlist_gl*)cl->data)->pipeline;
+	const spel_gfx_reflection_slot* slot =
+		spel_gfx_reflection_find(&pipeline->lookup.locations, cmd->location);
+	spel_gfx_shader_block* block = spel_gfx_reflection_block(pipeline, slot);
 
-	for (size_t i = 0; i < pipeline->reflection.uniform_count; i++)
+	if (block == NULL)
 	{
-		if (cmd->location == pipeline->reflection.uniforms[i].location)
-		{
-			binding = pipeline->reflection.uniforms[i].internal;
-		}
+		spel_warn("location %d not found within reflection data", cmd->location);
+		return;
 	}
 
-	for (size_t i = 0; i < pipeline->reflection.storage_count; i++)
+	uint32_t binding = block->internal;
+
+	// the block decides the target, not the buffer. a push always comes from the
+	// uniform ring, even when it feeds a storage block
+	GLenum target = slot->storage ? GL_SHADER_STORAGE_BUFFER : GL_UNIFORM_BUFFER;
+	GLuint buffer = ((spel_gfx_gl_buffer*)cmd->buf->data)->buffer;
+
+	if (cmd->size == 0)
 	{
-		if (cmd->location == pipeline->reflection.storage[i].location)
-		{
-			binding = pipeline->reflection.storage[i].internal;
-		}
+		glBindBufferBase(target, binding, buffer);
+		return;
 	}
 
-	if (binding == -1)
+	glBindBufferRange(target, binding, buffer, (GLintptr)cmd->offset,
+					  (GLsizeiptr)cmd->size);
+}
+
+// persistent buffers have no dynamic storage, their writes go through a staged
+// copy that's flushed right away so it stays in order with the commands around it
+static void spel_gl_cmd_buffer_write(spel_gfx_buffer buf, const void* data, size_t size,
+									 size_t offset)
+{
+	spel_gfx_gl_buffer* glBuf = (spel_gfx_gl_buffer*)buf->data;
+	if (glBuf->mapped)
 	{
-		spel_warn("location %d not found within reflection data", cmd->location);
+		spel_gl_upload_buffer(buf, data, size, offset);
+		spel_gl_upload_flush(buf->ctx);
 		return;
 	}
 
-	glBindBufferBase(cmd->buf->type == SPEL_GFX_BUFFER_UNIFORM ? GL_UNIFORM_BUFFER
-															   : GL_SHADER_STORAGE_BUFFER,
-					 binding, ((spel_gfx_gl_buffer*)cmd->buf->data)->buffer);
+	glNamedBufferSubData(glBuf->buffer, (GLintptr)offset, (GLsizeiptr)size, data);
 }
 
 void exec_cmd_uniform_update(spel_gfx_cmdlist cl, spel_gfx_uniform_update_cmd* cmd)
@@ -474,7 +1360,7 @@ void exec_cmd_uniform_update(spel_gfx_cmdlist cl, spel_gfx_uniform_update_cmd* c
 		memcpy((uint8_t*)glBuf->mirror + cmd->handle.offset, data, cmd->size);
 	}
 
-	glNamedBufferSubData(glBuf->buffer, cmd->handle.offset, cmd->size, data);
+	spel_gl_cmd_buffer_write(cmd->buffer.buffer, data, cmd->size, cmd->handle.offset);
 }
 
 void exec_cmd_buffer_update(spel_gfx_cmdlist cl, spel_gfx_buffer_update_cmd* cmd)
@@ -496,8 +1382,7 @@ void exec_cmd_buffer_update(spel_gfx_cmdlist cl, spel_gfx_buffer_update_cmd* cmd
 		memcpy((uint8_t*)glBuf->mirror + cmd->offset, data, cmd->size);
 	}
 
-	glNamedBufferSubData(glBuf->buffer, (GLintptr)cmd->offset, (GLsizeiptr)cmd->size,
-						 data);
+	spel_gl_cmd_buffer_write(cmd->buf, data, cmd->size, cmd->offset);
 }
 
 void exec_cmd_begin_render_pass(spel_gfx_cmdlist cl, spel_gfx_begin_render_pass_cmd* cmd)
@@ -523,7 +1408,7 @@ void exec_cmd_begin_render_pass(spel_gfx_cmdlist cl, spel_gfx_begin_render_pass_
 	GLuint fbo = pass->desc.framebuffer ? *(GLuint*)pass->desc.framebuffer->data
 										: 0; // 0 = default framebuffer
 
-	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	spel_gl_bind_fbo((spel_gfx_context_gl*)cl->ctx->data, fbo);
 	glDrawBuffers((int)data->draw_buffer_count, data->draw_buffers);
 
 	// Set viewport/scissor to the target size by default; user commands can override.
@@ -676,5 +1561,5 @@ void exec_cmd_end_render_pass(spel_gfx_cmdlist cl, spel_gfx_end_render_pass_cmd*
 
 	// Reset target height to default framebuffer dimensions.
 	glCmd->target_height = cl->ctx->fb_height;
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	spel_gl_bind_fbo((spel_gfx_context_gl*)cl->ctx->data, 0);
 }
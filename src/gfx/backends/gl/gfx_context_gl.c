@@ -8,6 +8,7 @@
 #include "gfx/gfx_types.h"
 #include "gfx_vtable_gl.h"
 #include <signal.h>
+#include <string.h>
 #define GLAD_GL_IMPLEMENTATION 1
 #include "gl.h"
 
@@ -62,7 +63,7 @@ static void spel_gl_vao_cache_clear(spel_gfx_vao_cache* cache)
 spel_hidden void spel_gfx_context_create_gl(spel_gfx_context ctx)
 {
 	spel_gfx_context_gl* gl =
-		(ctx->data = spel_memory_malloc(sizeof(spel_gfx_context_gl), SPEL_MEM_TAG_GFX));
+		(ctx->data = spel_memory_calloc(1, sizeof(spel_gfx_context_gl), SPEL_MEM_TAG_GFX));
 
 	gl->ctx = SDL_GL_CreateContext(spel.window.handle);
 	if (!gl->ctx)
@@ -100,6 +101,61 @@ spel_hidden void spel_gfx_context_create_gl(spel_gfx_context ctx)
 		return;
 	}
 
+	// ranges bound for uniform and storage blocks both have to land on this, rings
+	// raise their own alignment to match when the driver wants more than 256
+	GLint ubo_align = 0;
+	GLint ssbo_align = 0;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &ubo_align);
+	glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &ssbo_align);
+	ctx->uniform_align = (uint32_t)(ubo_align > ssbo_align ? ubo_align : ssbo_align);
+	if (ctx->uniform_align == 0)
+	{
+		ctx->uniform_align = SPEL_GFX_RING_ALIGN;
+	}
+
+	if ((ctx->uniform_align & (ctx->uniform_align - 1)) != 0)
+	{
+		spel_error(SPEL_ERR_CONTEXT_FAILED,
+				   "driver wants a %u byte buffer offset alignment, not a power of two",
+				   ctx->uniform_align);
+		SDL_GL_DestroyContext(gl->ctx);
+		ctx->vt = NULL;
+		ctx->data = NULL;
+		spel_memory_free(gl);
+		return;
+	}
+
+	spel_memory_pool_init_typed(&gl->pools.buffers, spel_gfx_buffer_slot_gl, 64,
+								SPEL_MEM_TAG_GFX);
+	spel_memory_pool_init_typed(&gl->pools.textures, spel_gfx_texture_slot_gl, 64,
+								SPEL_MEM_TAG_GFX);
+	spel_memory_pool_init_typed(&gl->pools.samplers, spel_gfx_sampler_slot_gl, 32,
+								SPEL_MEM_TAG_GFX);
+	spel_memory_pool_init_typed(&gl->pools.pipelines, spel_gfx_pipeline_slot_gl, 32,
+								SPEL_MEM_TAG_GFX);
+	spel_memory_pool_init_typed(&gl->pools.cmdlists, spel_gfx_cmdlist_slot_gl, 8,
+								SPEL_MEM_TAG_GFX);
+	spel_memory_pool_init(&gl->pools.cmd_chunks, "spel_gfx_cmd_chunk",
+						  spel_cmdlist_chunk_size, 8, SPEL_MEM_TAG_GFX);
+	atomic_flag_clear(&gl->chunk_lock);
+	spel_gl_upload_init(ctx);
+	spel_gl_program_binary_init(ctx);
+
+	// let the driver pick how many threads it links on
+	if (GLAD_GL_KHR_parallel_shader_compile)
+	{
+		glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+		gl->parallel_compile = true;
+	}
+	else if (GLAD_GL_ARB_parallel_shader_compile)
+	{
+		glMaxShaderCompilerThreadsARB(0xFFFFFFFFu);
+		gl->parallel_compile = true;
+	}
+
+	// a fresh context has nothing bound, which is what calloc left in the shadow
+	gl->validate_state = spel_args_has("--gfx-validate");
+
 	glEnable(GL_BLEND);
 
 	if (ctx->debug)
@@ -132,10 +188,18 @@ spel_hidden void spel_gfx_context_conf_gl()
 spel_hidden void spel_gfx_context_destroy_gl(spel_gfx_context ctx)
 {
 	spel_gfx_context_gl* gl = (spel_gfx_context_gl*)ctx->data;
+	spel_gl_upload_shutdown(ctx);
 	gladLoaderUnloadGL();
 	SDL_GL_DestroyContext(gl->ctx);
 	spel_gl_program_cache_clear(&ctx->program_cache);
 	spel_gl_vao_cache_clear(&ctx->vao_cache);
+
+	spel_memory_pool_destroy(&gl->pools.buffers);
+	spel_memory_pool_destroy(&gl->pools.textures);
+	spel_memory_pool_destroy(&gl->pools.samplers);
+	spel_memory_pool_destroy(&gl->pools.pipelines);
+	spel_memory_pool_destroy(&gl->pools.cmdlists);
+	spel_memory_pool_destroy(&gl->pools.cmd_chunks);
 	spel_memory_free(gl);
 	ctx->data = NULL;
 
@@ -147,8 +211,45 @@ spel_hidden void* spel_gfx_context_internal_handle_gl(spel_gfx_context ctx)
 	return ((spel_gfx_context_gl*)ctx->data)->ctx;
 }
 
+spel_hidden void spel_gl_state_validate(spel_gfx_context_gl* gl, const char* where)
+{
+	if (!gl->validate_state)
+	{
+		return;
+	}
+
+	GLint program = 0;
+	GLint vao = 0;
+	GLint fbo = 0;
+	glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+	glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &vao);
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &fbo);
+
+	if ((GLuint)program != gl->bound.program || (GLuint)vao != gl->bound.vao ||
+		(GLuint)fbo != gl->bound.fbo)
+	{
+		spel_warn("gl state shadow out of sync (%s): program %u/%d, vao %u/%d, fbo %u/%d. "
+				  "something bound gl state behind the backend's back",
+				  where, gl->bound.program, program, gl->bound.vao, vao, gl->bound.fbo,
+				  fbo);
+
+		// trust the driver from here on, and don't short-circuit the next pipeline
+		gl->bound.program = (GLuint)program;
+		gl->bound.vao = (GLuint)vao;
+		gl->bound.fbo = (GLuint)fbo;
+		gl->pipeline = NULL;
+		memset(&gl->state, 0, sizeof(gl->state));
+	}
+}
+
 spel_hidden void spel_gfx_frame_begin_gl(spel_gfx_context ctx)
 {
+	spel_gfx_context_gl* gl = (spel_gfx_context_gl*)ctx->data;
+	spel_gl_state_validate(gl, "frame begin");
+
+	// whatever got queued since the last submit goes out as one batch of copies
+	spel_gl_upload_flush(ctx);
+
 	// Keep drawable size in sync in case window-pixel events lag (e.g., Wayland live
 	// resize), but debounce heavy reallocations while the user is dragging.
 	const uint32_t RESIZE_DEBOUNCE_MS = 40; // tune for smoothness vs responsiveness
@@ -175,6 +276,7 @@ spel_hidden void spel_gfx_frame_begin_gl(spel_gfx_context ctx)
 		}
 	}
 
+	spel_gl_bind_fbo(gl, 0);
 	glViewport(0, 0, ctx->fb_width, ctx->fb_height);
 	glClearColor(0, 0, 0, 1);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
@@ -187,6 +289,33 @@ spel_hidden void spel_gfx_frame_end_gl(spel_gfx_context ctx)
 	SDL_GL_SwapWindow(spel.window.handle);
 }
 
+spel_hidden void* spel_gfx_fence_insert_gl(spel_gfx_context ctx)
+{
+	return glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+spel_hidden bool spel_gfx_fence_wait_gl(spel_gfx_context ctx, void* fence)
+{
+	GLsync sync = (GLsync)fence;
+	bool stalled = false;
+
+	// frame fences are usually long signaled, only flush once we know we'll block
+	GLenum status = glClientWaitSync(sync, 0, 0);
+	while (status == GL_TIMEOUT_EXPIRED)
+	{
+		stalled = true;
+		status = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ULL);
+	}
+
+	if (status == GL_WAIT_FAILED)
+	{
+		spel_error(SPEL_ERR_CONTEXT_FAILED, "glClientWaitSync failed on a frame fence");
+	}
+
+	glDeleteSync(sync);
+	return stalled;
+}
+
 const static char* gl_source_to_string(GLenum source)
 {
 	switch (source)
@@ -9,7 +9,7 @@ spel_hidden spel_gfx_framebuffer spel_gfx_framebuffer_create_gl(
 	spel_gfx_context ctx, const spel_gfx_framebuffer_desc* desc)
 {
 	spel_gfx_framebuffer fb =
-		(spel_gfx_framebuffer)spel_memory_malloc(sizeof(*fb), SPEL_MEM_TAG_GFX);
+		(spel_gfx_framebuffer)spel_memory_calloc(1, sizeof(*fb), SPEL_MEM_TAG_GFX);
 
 	fb->ctx = ctx;
 
@@ -68,11 +68,11 @@ spel_hidden spel_gfx_render_pass spel_gfx_render_pass_create_gl(
 	spel_gfx_context ctx, const spel_gfx_render_pass_desc* desc)
 {
 	spel_gfx_render_pass pass =
-		(spel_gfx_render_pass)spel_memory_malloc(sizeof(*pass), SPEL_MEM_TAG_GFX);
+		(spel_gfx_render_pass)spel_memory_calloc(1, sizeof(*pass), SPEL_MEM_TAG_GFX);
 
 	pass->ctx = ctx;
 	pass->desc = *desc;
-	pass->data = spel_memory_malloc(sizeof(spel_gfx_gl_framebuffer), SPEL_MEM_TAG_GFX);
+	pass->data = spel_memory_calloc(1, sizeof(spel_gfx_gl_framebuffer), SPEL_MEM_TAG_GFX);
 
 	spel_gfx_gl_framebuffer* data = (spel_gfx_gl_framebuffer*)pass->data;
 
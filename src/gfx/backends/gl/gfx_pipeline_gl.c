@@ -1,3 +1,4 @@
+#include "SDL3/SDL_filesystem.h"
 #include "core/entry.h"
 #include "core/log.h"
 #include "core/macros.h"
@@ -9,6 +10,17 @@
 #include <stdio.h>
 #include <string.h>
 
+#define SPEL_GL_PROGRAM_BINARY_MAGIC 0x4e49424c4c455053ULL // "SPELLBIN"
+
+typedef struct
+{
+	uint64_t magic;
+	uint64_t program;
+	uint64_t driver;
+	uint32_t format;
+	uint32_t size;
+} spel_gl_program_binary_header;
+
 static GLenum spel_gl_vertex_type(spel_gfx_vertex_base_format base, uint32_t bits);
 static GLenum spel_gl_primitive(spel_gfx_primitive_topology t);
 static GLenum spel_gl_cull(spel_gfx_cull_mode c);
@@ -18,13 +30,16 @@ static GLenum spel_gl_stencil_op(spel_gfx_stencil_op op);
 static GLenum spel_gl_blend_factor(spel_gfx_blend_factor f);
 static GLenum spel_gl_blend_op(spel_gfx_blend_op op);
 static uint64_t spel_hash_vertex_layout_value(const spel_gfx_vertex_layout* layout);
+static uint64_t spel_gl_pipeline_hash(uint64_t programHash, uint64_t stateHash);
 static uint64_t spel_gl_program_hash(spel_gfx_shader vertex, spel_gfx_shader fragment,
-									 spel_gfx_shader geometry);
+									 spel_gfx_shader geometry, spel_gfx_shader compute);
 static void spel_gl_program_cache_grow(spel_gfx_program_cache* cache);
 static GLuint spel_gl_program_cache_acquire(spel_gfx_context ctx, uint64_t hash,
 											spel_gfx_shader vertex,
 											spel_gfx_shader fragment,
-											spel_gfx_shader geometry);
+											spel_gfx_shader geometry,
+											spel_gfx_shader compute, bool deferred,
+											bool* pending);
 static void spel_gl_program_cache_release(spel_gfx_context ctx, uint64_t hash);
 static void spel_gl_vao_cache_grow(spel_gfx_vao_cache* cache);
 static spel_gfx_vao_cache_entry* spel_gl_vao_cache_acquire(
@@ -135,12 +150,219 @@ static void spel_gl_program_cache_grow(spel_gfx_program_cache* cache)
 	cache->capacity = new_capacity;
 }
 
+spel_hidden void spel_gl_program_binary_init(spel_gfx_context ctx)
+{
+	spel_gfx_context_gl* gl = (spel_gfx_context_gl*)ctx->data;
+	if (ctx->program_cache_dir == NULL)
+	{
+		return;
+	}
+
+	GLint formats = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+	if (formats == 0)
+	{
+		spel_warn("driver has no program binary formats, not caching programs");
+		return;
+	}
+
+	if (!SDL_CreateDirectory(ctx->program_cache_dir))
+	{
+		spel_warn("couldn't create program cache dir %s, not caching programs",
+				  ctx->program_cache_dir);
+		return;
+	}
+
+	const char* strings[3] = {(const char*)glGetString(GL_VENDOR),
+							  (const char*)glGetString(GL_RENDERER),
+							  (const char*)glGetString(GL_VERSION)};
+
+	XXH3_state_t* state = XXH3_createState();
+	XXH3_64bits_reset(state);
+	for (int i = 0; i < 3; i++)
+	{
+		// the terminator keeps "ab"+"c" and "a"+"bc" apart
+		const char* str = strings[i] ? strings[i] : "";
+		XXH3_64bits_update(state, str, strlen(str) + 1);
+	}
+	gl->program_binary.driver = XXH3_64bits_digest(state);
+	XXH3_freeState(state);
+
+	gl->program_binary.enabled = true;
+}
+
+static void spel_gl_program_binary_path(spel_gfx_context ctx, uint64_t hash, char* buf,
+										size_t bufSize)
+{
+	spel_gfx_context_gl* gl = (spel_gfx_context_gl*)ctx->data;
+	snprintf(buf, bufSize, "%s/%016llx-%016llx.glbin", ctx->program_cache_dir,
+			 (unsigned long long)hash, (unsigned long long)gl->program_binary.driver);
+}
+
+// returns 0 when there's nothing usable on disk, the caller links from source then
+static GLuint spel_gl_program_binary_load(spel_gfx_context ctx, uint64_t hash)
+{
+	spel_gfx_context_gl* gl = (spel_gfx_context_gl*)ctx->data;
+
+	char path[1024];
+	spel_gl_program_binary_path(ctx, hash, path, sizeof(path));
+
+	FILE* file = fopen(path, "rb");
+	if (!file)
+	{
+		return 0;
+	}
+
+	spel_gl_program_binary_header header;
+	void* data = NULL;
+	bool valid = fread(&header, sizeof(header), 1, file) == 1 &&
+				 header.magic == SPEL_GL_PROGRAM_BINARY_MAGIC &&
+				 header.program == hash && header.driver == gl->program_binary.driver &&
+				 header.size > 0;
+
+	if (valid)
+	{
+		data = spel_memory_malloc(header.size, SPEL_MEM_TAG_GFX);
+		valid = fread(data, header.size, 1, file) == 1;
+	}
+	fclose(file);
+
+	GLuint program = 0;
+	if (valid)
+	{
+		program = glCreateProgram();
+		glProgramBinary(program, header.format, data, (GLsizei)header.size);
+
+		// drivers reject binaries from before an update even with the same
+		// version string, that's not an error, it just gets relinked
+		GLint status = GL_FALSE;
+		glGetProgramiv(program, GL_LINK_STATUS, &status);
+		if (status != GL_TRUE)
+		{
+			glDeleteProgram(program);
+			program = 0;
+		}
+	}
+
+	spel_memory_free(data);
+
+	if (program == 0)
+	{
+		spel_debug("dropping stale program binary %s", path);
+		remove(path);
+	}
+
+	return program;
+}
+
+static void spel_gl_program_binary_store(spel_gfx_context ctx, uint64_t hash,
+										 GLuint program)
+{
+	spel_gfx_context_gl* gl = (spel_gfx_context_gl*)ctx->data;
+
+	GLint size = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &size);
+	if (size <= 0)
+	{
+		return;
+	}
+
+	spel_gl_program_binary_header header = {.magic = SPEL_GL_PROGRAM_BINARY_MAGIC,
+											.program = hash,
+											.driver = gl->program_binary.driver};
+
+	void* data = spel_memory_malloc((size_t)size, SPEL_MEM_TAG_GFX);
+	GLsizei written = 0;
+	GLenum format = 0;
+	glGetProgramBinary(program, size, &written, &format, data);
+	header.format = format;
+	header.size = (uint32_t)written;
+
+	char path[1024];
+	char tmp[1040];
+	spel_gl_program_binary_path(ctx, hash, path, sizeof(path));
+	snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+
+	// written next to it and renamed, so a crash never leaves half a binary behind
+	FILE* file = written > 0 ? fopen(tmp, "wb") : NULL;
+	if (file)
+	{
+		bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+				  fwrite(data, (size_t)written, 1, file) == 1;
+		ok = fclose(file) == 0 && ok;
+
+		if (!ok || rename(tmp, path) != 0)
+		{
+			spel_warn("couldn't write program binary %s", path);
+			remove(tmp);
+		}
+	}
+
+	spel_memory_free(data);
+}
+
+static bool spel_gl_program_link_check(GLuint program, uint64_t hash)
+{
+	GLint status = GL_FALSE;
+	glGetProgramiv(program, GL_LINK_STATUS, &status);
+	if (status == GL_TRUE)
+	{
+		return true;
+	}
+
+	char info_log[512];
+	GLsizei info_log_size = 0;
+	glGetProgramInfoLog(program, sizeof(info_log), &info_log_size, (GLchar*)info_log);
+
+	char str[24];
+	snprintf(str, sizeof(str), "%lx", (unsigned long)hash);
+
+	spel_gfx_shader_log log = {.name = str,
+							   .name_size = strlen(str),
+							   .log = info_log,
+							   .log_size = info_log_size};
+
+	spel_log(SPEL_SEV_ERROR, SPEL_ERR_SHADER_FAILED, &log, SPEL_DATA_SHADER_LOG,
+			 sizeof(log), "failed to link program %s: %s", str, info_log);
+	return false;
+}
+
+static spel_gfx_program_cache_entry* spel_gl_program_cache_find(spel_gfx_context ctx,
+																uint64_t hash)
+{
+	spel_gfx_program_cache* cache = &ctx->program_cache;
+	if (cache->capacity == 0)
+	{
+		return NULL;
+	}
+
+	uint32_t mask = cache->capacity - 1;
+	for (uint32_t index = (uint32_t)hash & mask; cache->entries[index].ref_count != 0;
+		 index = (index + 1) & mask)
+	{
+		if (cache->entries[index].hash == hash)
+		{
+			return &cache->entries[index];
+		}
+	}
+
+	return NULL;
+}
+
+// `deferred` skips waiting on the link when the driver links in parallel, the
+// entry stays pending until spel_gl_program_cache_resolve. a failed link leaves
+// a 0 handle behind so nothing tries it again
 static GLuint spel_gl_program_cache_acquire(spel_gfx_context ctx, uint64_t hash,
 											spel_gfx_shader vertex,
 											spel_gfx_shader fragment,
-											spel_gfx_shader geometry)
+											spel_gfx_shader geometry,
+											spel_gfx_shader compute, bool deferred,
+											bool* pending)
 {
 	spel_gfx_program_cache* cache = &ctx->program_cache;
+	spel_gfx_context_gl* gl = (spel_gfx_context_gl*)ctx->data;
+	bool binaries = gl->program_binary.enabled;
+	*pending = false;
 
 	if (cache->capacity == 0 || cache->count * 10 >= cache->capacity * 7)
 	{
@@ -156,7 +378,22 @@ static GLuint spel_gl_program_cache_acquire(spel_gfx_context ctx, uint64_t hash,
 
 		if (e->ref_count == 0)
 		{
-			GLuint program = glCreateProgram();
+			GLuint program = binaries ? spel_gl_program_binary_load(ctx, hash) : 0;
+			if (program != 0)
+			{
+				e->hash = hash;
+				e->handle = program;
+				e->ref_count = 1;
+				e->pending = false;
+				cache->count++;
+				return program;
+			}
+
+			program = glCreateProgram();
+			if (binaries)
+			{
+				glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+			}
 
 			if (vertex != NULL)
 			{
@@ -173,43 +410,50 @@ static GLuint spel_gl_program_cache_acquire(spel_gfx_context ctx, uint64_t hash,
 				glAttachShader(program, ((spel_gfx_shader_gl*)geometry->data)->shader);
 			}
 
-			glLinkProgram(program);
-
-			GLint status = GL_FALSE;
-			glGetProgramiv(program, GL_LINK_STATUS, &status);
-			if (status != GL_TRUE)
+			if (compute != NULL)
 			{
-				char info_log[512];
-				GLsizei info_log_size = 0;
-				glGetProgramInfoLog(program, sizeof(info_log), &info_log_size,
-									(GLchar*)info_log);
-
-				char str[24];
-				snprintf(str, sizeof(str), "%lx", (unsigned long)hash);
+				glAttachShader(program, ((spel_gfx_shader_gl*)compute->data)->shader);
+			}
 
-				spel_gfx_shader_log log = {.name = str,
-										   .name_size = strlen(str),
-										   .log = info_log,
-										   .log_size = info_log_size};
+			glLinkProgram(program);
 
-				spel_log(SPEL_SEV_ERROR, SPEL_ERR_SHADER_FAILED, &log,
-						 SPEL_DATA_SHADER_LOG, sizeof(log),
-						 "failed to link program %s: %s", str, info_log);
+			e->pending = deferred && gl->parallel_compile;
+			if (!e->pending)
+			{
+				if (!spel_gl_program_link_check(program, hash))
+				{
+					// same as a failed deferred link, the entry remembers it
+					glDeleteProgram(program);
+					e->hash = hash;
+					e->handle = 0;
+					e->ref_count = 1;
+					cache->count++;
+					return 0;
+				}
 
-				glDeleteProgram(program);
-				return 0;
+				if (binaries)
+				{
+					spel_gl_program_binary_store(ctx, hash, program);
+				}
 			}
 
 			e->hash = hash;
 			e->handle = program;
 			e->ref_count = 1;
 			cache->count++;
+			*pending = e->pending;
 			return program;
 		}
 
 		if (e->hash == hash)
 		{
+			if (e->handle == 0)
+			{
+				return 0;
+			}
+
 			e->ref_count++;
+			*pending = e->pending;
 			return e->handle;
 		}
 
@@ -217,6 +461,36 @@ static GLuint spel_gl_program_cache_acquire(spel_gfx_context ctx, uint64_t hash,
 	}
 }
 
+// waits for a pending link to finish and checks it, returns 0 if it failed
+static GLuint spel_gl_program_cache_resolve(spel_gfx_context ctx, uint64_t hash)
+{
+	spel_gfx_program_cache_entry* e = spel_gl_program_cache_find(ctx, hash);
+	if (e == NULL)
+	{
+		return 0;
+	}
+
+	if (!e->pending)
+	{
+		return e->handle;
+	}
+
+	e->pending = false;
+	if (!spel_gl_program_link_check(e->handle, hash))
+	{
+		glDeleteProgram(e->handle);
+		e->handle = 0;
+		return 0;
+	}
+
+	if (((spel_gfx_context_gl*)ctx->data)->program_binary.enabled)
+	{
+		spel_gl_program_binary_store(ctx, hash, e->handle);
+	}
+
+	return e->handle;
+}
+
 static void spel_gl_program_cache_release(spel_gfx_context ctx, uint64_t hash)
 {
 	spel_gfx_program_cache* cache = &ctx->program_cache;
@@ -429,8 +703,80 @@ XXH3_state_t* pipeline_state = NULL;
 XXH3_state_t* gl_pipeline_state = NULL;
 uint64_t pipeline_count = 0;
 
-spel_gfx_pipeline spel_gfx_pipeline_create_gl(spel_gfx_context ctx,
-											  const spel_gfx_pipeline_desc* desc)
+// a compute pipeline is nothing but its program, no vao and no render state
+static spel_gfx_pipeline
+spel_gl_compute_pipeline_create(spel_gfx_context ctx, const spel_gfx_pipeline_desc* desc,
+								bool deferred)
+{
+	if (desc->compute_shader->type != SPEL_GFX_SHADER_COMPUTE)
+	{
+		spel_error(SPEL_ERR_INVALID_ARGUMENT, "compute_shader must be a compute stage");
+		return NULL;
+	}
+
+	if (desc->vertex_shader || desc->fragment_shader || desc->geometry_shader)
+	{
+		spel_error(SPEL_ERR_INVALID_ARGUMENT,
+				   "a compute pipeline takes the compute stage and nothing else");
+		return NULL;
+	}
+
+	uint64_t program_hash = spel_gl_program_hash(NULL, NULL, NULL, desc->compute_shader);
+
+	spel_gfx_pipeline pipeline =
+		spel_gfx_pipeline_cache_get(&ctx->pipeline_cache, program_hash);
+	if (pipeline)
+	{
+		return pipeline;
+	}
+
+	spel_gfx_pipeline_slot_gl* slot =
+		spel_memory_pool_alloc(&((spel_gfx_context_gl*)ctx->data)->pools.pipelines);
+	if (!slot)
+	{
+		spel_error(SPEL_ERR_OOM, "failed to allocate pipeline object");
+		return NULL;
+	}
+
+	pipeline = &slot->handle;
+	pipeline->hash = program_hash;
+
+	spel_gfx_shader shaders[1] = {desc->compute_shader};
+	spel_gfx_pipeline_merge_reflections(pipeline, shaders, 1);
+
+	pipeline->ctx = ctx;
+	pipeline->type = SPEL_GFX_PIPELINE_COMPUTE;
+	pipeline->blended = false;
+	pipeline->data = &slot->gl;
+
+	spel_gfx_pipeline_gl* gl_pipeline = (spel_gfx_pipeline_gl*)pipeline->data;
+	gl_pipeline->program_hash = program_hash;
+	gl_pipeline->vao_hash = 0;
+	gl_pipeline->state_hash = 0;
+	gl_pipeline->vao = 0;
+	gl_pipeline->strides = NULL;
+
+	GLuint program = spel_gl_program_cache_acquire(ctx, program_hash, NULL, NULL, NULL,
+												   desc->compute_shader, deferred,
+												   &gl_pipeline->pending);
+	if (program == 0)
+	{
+		gl_pipeline->program_hash = 0;
+		spel_gfx_pipeline_destroy(pipeline);
+		return NULL;
+	}
+	gl_pipeline->program = program;
+	pipeline->compute_shader = desc->compute_shader;
+
+	spel_gfx_pipeline_cache_insert(&ctx->pipeline_cache, program_hash, pipeline);
+
+	pipeline_count++;
+	return pipeline;
+}
+
+static spel_gfx_pipeline spel_gl_pipeline_create(spel_gfx_context ctx,
+												 const spel_gfx_pipeline_desc* desc,
+												 bool deferred)
 {
 	if (pipeline_state == NULL)
 	{
@@ -438,6 +784,11 @@ spel_gfx_pipeline spel_gfx_pipeline_create_gl(spel_gfx_context ctx,
 		gl_pipeline_state = XXH3_createState();
 	}
 
+	if (desc->compute_shader != NULL)
+	{
+		return spel_gl_compute_pipeline_create(ctx, desc, deferred);
+	}
+
 	XXH3_64bits_reset(pipeline_state);
 
 	uint8_t shaderCount = 0;
@@ -462,9 +813,7 @@ spel_gfx_pipeline spel_gfx_pipeline_create_gl(spel_gfx_context ctx,
 	}
 
 	uint64_t program_hash = spel_gl_program_hash(
-		desc->vertex_shader, desc->fragment_shader, desc->geometry_shader);
-
-	XXH3_64bits_update(pipeline_state, &program_hash, sizeof(program_hash));
+		desc->vertex_shader, desc->fragment_shader, desc->geometry_shader, NULL);
 
 	spel_hash_vertex_layout(pipeline_state, &desc->vertex_layout);
 	uint64_t vao_hash = spel_hash_vertex_layout_value(&desc->vertex_layout);
@@ -479,7 +828,8 @@ spel_gfx_pipeline spel_gfx_pipeline_create_gl(spel_gfx_context ctx,
 
 	XXH3_64bits_update(pipeline_state, &desc->scissor_test, sizeof(desc->scissor_test));
 
-	uint64_t pipeline_hash = XXH3_64bits_digest(pipeline_state);
+	uint64_t state_hash = XXH3_64bits_digest(pipeline_state);
+	uint64_t pipeline_hash = spel_gl_pipeline_hash(program_hash, state_hash);
 
 	spel_gfx_pipeline pipeline =
 		spel_gfx_pipeline_cache_get(&ctx->pipeline_cache, pipeline_hash);
@@ -489,23 +839,29 @@ spel_gfx_pipeline spel_gfx_pipeline_create_gl(spel_gfx_context ctx,
 		return pipeline;
 	}
 
-	pipeline =
-		spel_memory_malloc(sizeof(*pipeline), SPEL_MEM_TAG_GFX);
-	memset(pipeline, 0, sizeof(*pipeline));
+	spel_gfx_pipeline_slot_gl* slot =
+		spel_memory_pool_alloc(&((spel_gfx_context_gl*)ctx->data)->pools.pipelines);
+	if (!slot)
+	{
+		spel_error(SPEL_ERR_OOM, "failed to allocate pipeline object");
+		return NULL;
+	}
+
+	pipeline = &slot->handle;
 	pipeline->hash = pipeline_hash;
 
 	spel_gfx_pipeline_merge_reflections(pipeline, shaders, shaderCount);
 
 	pipeline->ctx = ctx;
 	pipeline->type = SPEL_GFX_PIPELINE_GRAPHIC;
+	pipeline->blended = desc->blend_state.enabled;
 
-	pipeline->data = (spel_gfx_pipeline_gl*)spel_memory_malloc(
-		sizeof(spel_gfx_pipeline_gl), SPEL_MEM_TAG_GFX);
+	pipeline->data = &slot->gl;
 
 	spel_gfx_pipeline_gl* gl_pipeline = (spel_gfx_pipeline_gl*)pipeline->data;
-	memset(gl_pipeline, 0, sizeof(*gl_pipeline));
 	gl_pipeline->program_hash = program_hash;
 	gl_pipeline->vao_hash = vao_hash;
+	gl_pipeline->state_hash = state_hash;
 	gl_pipeline->scissor_test = desc->scissor_test;
 
 	spel_gl_cache_pipeline_state(gl_pipeline, desc);
@@ -520,9 +876,9 @@ spel_gfx_pipeline spel_gfx_pipeline_create_gl(spel_gfx_context ctx,
 	gl_pipeline->vao = vao_entry->handle;
 	gl_pipeline->strides = (GLsizei*)vao_entry->strides;
 
-	GLuint program =
-		spel_gl_program_cache_acquire(ctx, gl_pipeline->program_hash, desc->vertex_shader,
-									  desc->fragment_shader, desc->geometry_shader);
+	GLuint program = spel_gl_program_cache_acquire(
+		ctx, gl_pipeline->program_hash, desc->vertex_shader, desc->fragment_shader,
+		desc->geometry_shader, NULL, deferred, &gl_pipeline->pending);
 	if (program == 0)
 	{
 		spel_gl_vao_cache_release(ctx, gl_pipeline->vao_hash);
@@ -554,15 +910,138 @@ spel_gfx_pipeline spel_gfx_pipeline_create_gl(spel_gfx_context ctx,
 	return pipeline;
 }
 
+spel_gfx_pipeline spel_gfx_pipeline_create_gl(spel_gfx_context ctx,
+											  const spel_gfx_pipeline_desc* desc)
+{
+	return spel_gl_pipeline_create(ctx, desc, false);
+}
+
+spel_gfx_pipeline spel_gfx_pipeline_precompile_gl(spel_gfx_context ctx,
+												  const spel_gfx_pipeline_desc* desc)
+{
+	return spel_gl_pipeline_create(ctx, desc, true);
+}
+
+spel_hidden void spel_gl_pipeline_resolve(spel_gfx_pipeline pipeline)
+{
+	spel_gfx_pipeline_gl* glp = (spel_gfx_pipeline_gl*)pipeline->data;
+	glp->pending = false;
+	glp->program = spel_gl_program_cache_resolve(pipeline->ctx, glp->program_hash);
+}
+
+bool spel_gfx_pipeline_ready_gl(spel_gfx_pipeline pipeline)
+{
+	spel_gfx_pipeline_gl* glp = (spel_gfx_pipeline_gl*)pipeline->data;
+	if (!glp->pending)
+	{
+		return true;
+	}
+
+	// asking for the completion status never blocks, the link status would
+	GLint done = GL_FALSE;
+	glGetProgramiv(glp->program, GL_COMPLETION_STATUS_KHR, &done);
+	if (done != GL_TRUE)
+	{
+		return false;
+	}
+
+	spel_gl_pipeline_resolve(pipeline);
+	return true;
+}
+
+// the shaders were patched in place, so relinking is just acquiring the program for
+// their new hashes and letting the old one's refcount drop. pipelines sharing the
+// program link it once, anything not using a changed shader is never touched
+bool spel_gfx_pipeline_reload_gl(spel_gfx_pipeline pipeline)
+{
+	spel_gfx_pipeline_gl* glp = (spel_gfx_pipeline_gl*)pipeline->data;
+	spel_gfx_context_gl* gl = (spel_gfx_context_gl*)pipeline->ctx->data;
+	spel_gfx_context ctx = pipeline->ctx;
+
+	uint64_t program_hash =
+		spel_gl_program_hash(pipeline->vertex_shader, pipeline->fragment_shader,
+							 pipeline->geometry_shader, pipeline->compute_shader);
+	if (program_hash == glp->program_hash)
+	{
+		return true;
+	}
+
+	bool pending = false;
+	GLuint program = spel_gl_program_cache_acquire(
+		ctx, program_hash, pipeline->vertex_shader, pipeline->fragment_shader,
+		pipeline->geometry_shader, pipeline->compute_shader, false, &pending);
+	if (program == 0)
+	{
+		return false;
+	}
+
+	if (gl->pipeline == pipeline)
+	{
+		gl->pipeline = NULL;
+		spel_gl_use_program(gl, 0);
+	}
+
+	spel_gl_program_cache_release(ctx, glp->program_hash);
+	glp->program_hash = program_hash;
+	glp->program = program;
+	glp->pending = false;
+
+	spel_gfx_shader shaders[3];
+	uint32_t shader_count = 0;
+	if (pipeline->type == SPEL_GFX_PIPELINE_COMPUTE)
+	{
+		shaders[shader_count++] = pipeline->compute_shader;
+	}
+	else
+	{
+		if (pipeline->vertex_shader != NULL)
+		{
+			shaders[shader_count++] = pipeline->vertex_shader;
+		}
+
+		if (pipeline->fragment_shader != NULL)
+		{
+			shaders[shader_count++] = pipeline->fragment_shader;
+		}
+
+		if (pipeline->geometry_shader != NULL)
+		{
+			shaders[shader_count++] = pipeline->geometry_shader;
+		}
+	}
+
+	spel_gfx_pipeline_reflection_free(pipeline);
+	spel_gfx_pipeline_merge_reflections(pipeline, shaders, shader_count);
+
+	// the same desc with the new shaders has to find this pipeline again
+	spel_gfx_pipeline_cache_remove(&ctx->pipeline_cache, pipeline->hash, pipeline);
+	pipeline->hash = pipeline->type == SPEL_GFX_PIPELINE_COMPUTE
+						 ? program_hash
+						 : spel_gl_pipeline_hash(program_hash, glp->state_hash);
+	spel_gfx_pipeline_cache_insert(&ctx->pipeline_cache, pipeline->hash, pipeline);
+
+	return true;
+}
+
 void spel_gfx_pipeline_destroy_gl(spel_gfx_pipeline pipeline)
 {
 	spel_gfx_pipeline_gl* glp = (spel_gfx_pipeline_gl*)pipeline->data;
+	spel_gfx_context_gl* gl = (spel_gfx_context_gl*)pipeline->ctx->data;
+
+	// the slot can come back as a different pipeline, and a deleted vao silently
+	// falls back to 0, so get it out of the shadow first
+	if (gl->pipeline == pipeline)
+	{
+		gl->pipeline = NULL;
+		spel_gl_use_program(gl, 0);
+		spel_gl_bind_vao(gl, 0);
+	}
 
 	spel_gl_vao_cache_release(pipeline->ctx, glp->vao_hash);
 	spel_gl_program_cache_release(pipeline->ctx, glp->program_hash);
 
-	spel_memory_free(pipeline->data);
-	spel_memory_free(pipeline);
+	spel_memory_pool_free(&((spel_gfx_context_gl*)pipeline->ctx->data)->pools.pipelines,
+						  pipeline);
 
 	if (pipeline_count > 0)
 	{
@@ -797,8 +1276,16 @@ static uint64_t spel_hash_vertex_layout_value(const spel_gfx_vertex_layout* layo
 	return XXH3_64bits_digest(gl_pipeline_state);
 }
 
+// kept apart from the render state so a reloaded program can rekey its pipeline
+// without the desc it was made from
+static uint64_t spel_gl_pipeline_hash(uint64_t programHash, uint64_t stateHash)
+{
+	uint64_t parts[2] = {programHash, stateHash};
+	return XXH3_64bits(parts, sizeof(parts));
+}
+
 static uint64_t spel_gl_program_hash(spel_gfx_shader vertex, spel_gfx_shader fragment,
-									 spel_gfx_shader geometry)
+									 spel_gfx_shader geometry, spel_gfx_shader compute)
 {
 	XXH3_64bits_reset(gl_pipeline_state);
 
@@ -823,5 +1310,12 @@ static uint64_t spel_gl_program_hash(spel_gfx_shader vertex, spel_gfx_shader fra
 		XXH3_64bits_update(gl_pipeline_state, &geometry->hash, sizeof(geometry->hash));
 	}
 
+	if (compute != NULL)
+	{
+		uint8_t tag = (uint8_t)SPEL_GFX_SHADER_COMPUTE;
+		XXH3_64bits_update(gl_pipeline_state, &tag, sizeof(tag));
+		XXH3_64bits_update(gl_pipeline_state, &compute->hash, sizeof(compute->hash));
+	}
+
 	return XXH3_64bits_digest(gl_pipeline_state);
 }
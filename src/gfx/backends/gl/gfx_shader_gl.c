@@ -12,6 +12,8 @@
 #include <stdio.h>
 #include <string.h>
 
+#define SPEL_GL_MAX_SPEC_CONSTANTS 64
+
 spel_gfx_shader spel_gfx_shader_create_spirv_gl(spel_gfx_shader shader,
 												spel_gfx_shader_desc* desc);
 
@@ -79,6 +81,15 @@ spel_gfx_shader spel_gfx_shader_create_spirv_gl(spel_gfx_shader shader,
 
 	XXH3_64bits_update(state, desc->source, desc->source_size);
 
+	// same spir-v with other constants is a different shader once specialized
+	spel_gfx_shader_reflection* refl = &shader->reflection;
+	for (uint32_t i = 0; i < refl->constant_count; i++)
+	{
+		XXH3_64bits_update(state, &refl->constants[i].id, sizeof(refl->constants[i].id));
+		XXH3_64bits_update(state, &refl->constants[i].value,
+						   sizeof(refl->constants[i].value));
+	}
+
 	shader->hash = XXH3_64bits_digest(state);
 	XXH3_freeState(state);
 
@@ -98,8 +109,24 @@ spel_gfx_shader spel_gfx_shader_create_spirv_gl(spel_gfx_shader shader,
 	glShaderBinary(1, &(*(spel_gfx_shader_gl*)shader->data).shader,
 				   GL_SHADER_BINARY_FORMAT_SPIR_V, desc->source, src_size);
 
-	glSpecializeShader((*(spel_gfx_shader_gl*)shader->data).shader, shader->entry, 0,
-					   NULL, NULL);
+	GLuint ids[SPEL_GL_MAX_SPEC_CONSTANTS];
+	GLuint values[SPEL_GL_MAX_SPEC_CONSTANTS];
+	uint32_t constant_count = refl->constant_count;
+	if (constant_count > SPEL_GL_MAX_SPEC_CONSTANTS)
+	{
+		spel_warn("shader %s has %u specialization constants, only the first %d are set",
+				  desc->debug_name, constant_count, SPEL_GL_MAX_SPEC_CONSTANTS);
+		constant_count = SPEL_GL_MAX_SPEC_CONSTANTS;
+	}
+
+	for (uint32_t i = 0; i < constant_count; i++)
+	{
+		ids[i] = refl->constants[i].id;
+		values[i] = refl->constants[i].value;
+	}
+
+	glSpecializeShader((*(spel_gfx_shader_gl*)shader->data).shader, shader->entry,
+					   constant_count, ids, values);
 
 	GLint compiled = GL_FALSE;
 	glGetShaderiv((*(spel_gfx_shader_gl*)shader->data).shader, GL_COMPILE_STATUS,
@@ -158,9 +185,16 @@ void spel_gfx_shader_patch_gl(spel_gfx_shader shader, spel_gfx_shader_desc* desc
 		return;
 	}
 
+	spel_memory_frame_marker marker = spel_memory_frame_mark();
 	SpvReflectDescriptorBinding** bindings =
-		(SpvReflectDescriptorBinding**)spel_memory_malloc(
+		(SpvReflectDescriptorBinding**)spel_memory_frame_alloc(binding_count *
+															   sizeof(*bindings));
+	bool bindings_owned = bindings == NULL;
+	if (bindings_owned)
+	{
+		bindings = (SpvReflectDescriptorBinding**)spel_memory_malloc(
 			binding_count * sizeof(*bindings), SPEL_MEM_TAG_GFX);
+	}
 
 	if (spvReflectEnumerateDescriptorBindings(&module, &binding_count, bindings) !=
 		SPV_REFLECT_RESULT_SUCCESS)
@@ -234,6 +268,10 @@ void spel_gfx_shader_patch_gl(spel_gfx_shader shader, spel_gfx_shader_desc* desc
 
 	desc->source = newBuf;
 
-	spel_memory_free((void*)bindings);
+	if (bindings_owned)
+	{
+		spel_memory_free((void*)bindings);
+	}
+	spel_memory_frame_rewind(marker);
 	spvReflectDestroyShaderModule(&module);
 }
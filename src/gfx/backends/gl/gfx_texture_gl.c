@@ -60,30 +60,31 @@ static GLenum spel_gl_texture_target(spel_gfx_texture_type type)
 	return GL_TEXTURE_2D;
 }
 
-spel_gfx_texture spel_gfx_texture_create_gl(spel_gfx_context ctx,
-											const spel_gfx_texture_desc* desc)
+static bool spel_gl_texture_format_check(const spel_gfx_texture_desc* desc)
 {
-	if (!spel_gfx_texture_validate(desc))
-	{
-		spel_warn("invalid texture description (w:%d h:%d d:%d mips:%d type:%d)",
-				desc->width, desc->height, desc->depth, desc->mip_count, desc->type);
-		return ctx->checkerboard != NULL ? ctx->checkerboard : NULL;
-	}
-
 	const spel_gfx_gl_format_info* fmt = &GL_FORMATS[desc->format];
 
 	if ((desc->usage & SPEL_GFX_TEXTURE_USAGE_RENDER) && !fmt->renderable)
 	{
 		spel_error(SPEL_ERR_INVALID_ARGUMENT, "format not renderable");
-		return NULL;
+		return false;
 	}
 
 	if ((desc->usage & SPEL_GFX_TEXTURE_USAGE_STORAGE) && !fmt->storage)
 	{
 		spel_error(SPEL_ERR_INVALID_ARGUMENT, "format not storage-capable");
-		return NULL;
+		return false;
 	}
 
+	return true;
+}
+
+// makes the gl texture behind `texture` from `desc`, uploading and building mips
+// when it carries data. whatever was there before has to be gone already
+static bool spel_gl_texture_storage(spel_gfx_texture texture,
+									const spel_gfx_texture_desc* desc)
+{
+	const spel_gfx_gl_format_info* fmt = &GL_FORMATS[desc->format];
 	uint32_t max_mips = 1 + (uint32_t)floor(log2(fmax(desc->width, desc->height)));
 
 	uint32_t mip_count = desc->mip_count == 0 ? max_mips : desc->mip_count;
@@ -98,35 +99,18 @@ spel_gfx_texture spel_gfx_texture_create_gl(spel_gfx_context ctx,
 	}
 #endif
 
-	spel_gfx_texture texture =
-		(spel_gfx_texture)spel_memory_malloc(sizeof(*texture), SPEL_MEM_TAG_GFX);
-	if (!texture)
-	{
-		spel_error(SPEL_ERR_OOM, "failed to allocate texture object");
-		return NULL;
-	}
-
 	if (desc->usage & SPEL_GFX_TEXTURE_USAGE_RENDER)
 	{
 		mip_count = 1;
 	}
 
-	texture->ctx = ctx;
 	texture->type = desc->type;
-	texture->internal = false;
 	texture->width = desc->width;
 	texture->height = desc->height;
 	texture->format = desc->format;
 	texture->mip_count = mip_count;
 	texture->depth = desc->depth == 0 ? 1 : desc->depth;
 
-	texture->data = spel_memory_malloc(sizeof(GLuint), SPEL_MEM_TAG_GFX);
-	if (!texture->data)
-	{
-		spel_error(SPEL_ERR_OOM, "failed to allocate GL handle storage");
-		spel_memory_free(texture);
-		return NULL;
-	}
 	GLuint* gl_handle = (GLuint*)texture->data;
 
 	GLenum target = spel_gl_texture_target(desc->type);
@@ -134,9 +118,7 @@ spel_gfx_texture spel_gfx_texture_create_gl(spel_gfx_context ctx,
 	if (*gl_handle == 0)
 	{
 		spel_error(SPEL_ERR_CONTEXT_FAILED, "glCreateTextures returned 0");
-		spel_memory_free(texture->data);
-		spel_memory_free(texture);
-		return NULL;
+		return false;
 	}
 
 	if (desc->type == SPEL_GFX_TEXTURE_2D)
@@ -188,9 +170,105 @@ spel_gfx_texture spel_gfx_texture_create_gl(spel_gfx_context ctx,
 	spel_trace("created GL texture %u (%dx%dx%d, mips=%d, fmt=%d)", *gl_handle, desc->width,
 			 desc->height, desc->depth, desc->mip_count, desc->format);
 
+	return true;
+}
+
+spel_gfx_texture spel_gfx_texture_create_gl(spel_gfx_context ctx,
+											const spel_gfx_texture_desc* desc)
+{
+	if (!spel_gfx_texture_validate(desc))
+	{
+		spel_warn("invalid texture description (w:%d h:%d d:%d mips:%d type:%d)",
+				desc->width, desc->height, desc->depth, desc->mip_count, desc->type);
+		return ctx->checkerboard != NULL ? ctx->checkerboard : NULL;
+	}
+
+	if (!spel_gl_texture_format_check(desc))
+	{
+		return NULL;
+	}
+
+	spel_memory_pool* pool = &((spel_gfx_context_gl*)ctx->data)->pools.textures;
+	spel_gfx_texture_slot_gl* slot = spel_memory_pool_alloc(pool);
+	if (!slot)
+	{
+		spel_error(SPEL_ERR_OOM, "failed to allocate texture object");
+		return NULL;
+	}
+	spel_gfx_texture texture = &slot->handle;
+
+	texture->ctx = ctx;
+	texture->internal = false;
+	texture->loading = false;
+	texture->data = &slot->gl;
+
+	if (!spel_gl_texture_storage(texture, desc))
+	{
+		spel_memory_pool_free(pool, slot);
+		return NULL;
+	}
+
+	return texture;
+}
+
+// a new texture sharing the source's storage, deleting it leaves the source alone
+spel_gfx_texture spel_gfx_texture_view_gl(spel_gfx_texture source)
+{
+	spel_memory_pool* pool = &((spel_gfx_context_gl*)source->ctx->data)->pools.textures;
+	spel_gfx_texture_slot_gl* slot = spel_memory_pool_alloc(pool);
+	if (!slot)
+	{
+		spel_error(SPEL_ERR_OOM, "failed to allocate texture object");
+		return NULL;
+	}
+
+	spel_gfx_texture texture = &slot->handle;
+	*texture = *source;
+	texture->internal = false;
+	texture->loading = false;
+	texture->data = &slot->gl;
+
+	uint32_t layers = 1;
+	if (source->type == SPEL_GFX_TEXTURE_2D_ARRAY)
+	{
+		layers = source->depth;
+	}
+	else if (source->type == SPEL_GFX_TEXTURE_CUBE)
+	{
+		layers = 6;
+	}
+
+	// a view wants a name that was never bound, glCreateTextures would give it a
+	// target already
+	glGenTextures(1, &slot->gl);
+	glTextureView(slot->gl, spel_gl_texture_target(source->type), *(GLuint*)source->data,
+				  GL_FORMATS[source->format].internal_format, 0, source->mip_count, 0,
+				  layers);
+
 	return texture;
 }
 
+// swaps what's behind the handle for a new texture, every reference to it sees
+// the new contents from then on
+bool spel_gfx_texture_replace_gl(spel_gfx_texture texture,
+								 const spel_gfx_texture_desc* desc)
+{
+	if (!spel_gfx_texture_validate(desc) || !spel_gl_texture_format_check(desc))
+	{
+		spel_warn("can't replace texture with %dx%d (mips:%d type:%d fmt:%d)", desc->width,
+				  desc->height, desc->mip_count, desc->type, desc->format);
+		return false;
+	}
+
+	spel_gl_upload_flush(texture->ctx);
+
+	GLuint* gl_handle = (GLuint*)texture->data;
+	glDeleteTextures(1, gl_handle);
+	*gl_handle = 0;
+
+	return spel_gl_texture_storage(texture, desc);
+}
+
 void spel_gfx_texture_destroy_gl(spel_gfx_texture texture)
 {
 	if (texture->internal)
@@ -199,21 +277,29 @@ void spel_gfx_texture_destroy_gl(spel_gfx_texture texture)
 		return;
 	}
 
+	spel_gl_upload_flush(texture->ctx);
+
 	GLuint handle = *(GLuint*)texture->data;
 	glDeleteTextures(1, &handle);
 	spel_trace("destroyed GL texture %u", handle);
-	spel_memory_free(texture->data);
-	spel_memory_free(texture);
+	spel_memory_pool_free(&((spel_gfx_context_gl*)texture->ctx->data)->pools.textures,
+						  texture);
 }
 
 spel_gfx_sampler spel_gfx_sampler_create_gl(spel_gfx_context ctx,
 											const spel_gfx_sampler_desc* desc)
 {
-	spel_gfx_sampler sampler =
-		(spel_gfx_sampler)spel_memory_malloc(sizeof(*sampler), SPEL_MEM_TAG_GFX);
+	spel_gfx_sampler_slot_gl* slot =
+		spel_memory_pool_alloc(&((spel_gfx_context_gl*)ctx->data)->pools.samplers);
+	if (!slot)
+	{
+		spel_error(SPEL_ERR_OOM, "failed to allocate sampler object");
+		return NULL;
+	}
 
+	spel_gfx_sampler sampler = &slot->handle;
 	sampler->ctx = ctx;
-	sampler->data = spel_memory_malloc(sizeof(GLuint), SPEL_MEM_TAG_GFX);
+	sampler->data = &slot->gl;
 	GLuint* gl_handle = (GLuint*)sampler->data;
 
 	glCreateSamplers(1, gl_handle);
@@ -255,8 +341,8 @@ void spel_gfx_sampler_destroy_gl(spel_gfx_sampler sampler)
 		glDeleteSamplers(1, gl_handle);
 	}
 
-	spel_memory_free(sampler->data);
-	spel_memory_free(sampler);
+	spel_memory_pool_free(&((spel_gfx_context_gl*)sampler->ctx->data)->pools.samplers,
+						  sampler);
 }
 
 spel_hidden void spel_gfx_texture_resize_gl(spel_gfx_texture tex, uint32_t width,
@@ -270,6 +356,8 @@ spel_hidden void spel_gfx_texture_resize_gl(spel_gfx_texture tex, uint32_t width
 		return;
 	}
 
+	spel_gl_upload_flush(tex->ctx);
+
 	GLuint* gl_handle = (GLuint*)tex->data;
 	glDeleteTextures(1, gl_handle);
 	GLenum target = spel_gl_texture_target(tex->type);
@@ -308,12 +396,19 @@ spel_hidden void spel_gfx_texture_resize_gl(spel_gfx_texture tex, uint32_t width
 spel_hidden void spel_gfx_texture_update_gl(spel_gfx_texture texture, uint32_t mip,
 										  spel_rect region, void* data, size_t dataSize)
 {
+	const spel_gfx_gl_format_info* fmt = &GL_FORMATS[texture->format];
+
+	// source rows are texture->width pixels apart
+	if (fmt->bytes_per_pixel != 0)
+	{
+		spel_gl_upload_texture(texture, mip, region, data, texture->width);
+		return;
+	}
+
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 	glPixelStorei(GL_UNPACK_ROW_LENGTH, texture->width);
-	
-	GLuint* gl_handle = (GLuint*)texture->data;
-	const spel_gfx_gl_format_info* fmt = &GL_FORMATS[texture->format];
 
+	GLuint* gl_handle = (GLuint*)texture->data;
 	glTextureSubImage2D(*gl_handle, mip, region.x, region.y, region.width, region.height,
 						fmt->external_format, fmt->type, data);
 }
\ No newline at end of file
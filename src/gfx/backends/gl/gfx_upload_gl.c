@@ -0,0 +1,326 @@
+#include "SDL3/SDL_thread.h"
+#include "core/log.h"
+#include "core/memory.h"
+#include "gfx/gfx_internal.h"
+#include "gfx_vtable_gl.h"
+#include "gl.h"
+#include "gl_types.h"
+#include <string.h>
+
+#define SPEL_GL_UPLOAD_ALIGN 16
+
+static void spel_gl_upload_lock(spel_gl_upload_heap* heap)
+{
+	while (atomic_flag_test_and_set_explicit(&heap->lock, memory_order_acquire))
+	{
+	}
+}
+
+static void spel_gl_upload_unlock(spel_gl_upload_heap* heap)
+{
+	atomic_flag_clear_explicit(&heap->lock, memory_order_release);
+}
+
+spel_hidden void spel_gl_upload_init(spel_gfx_context ctx)
+{
+	spel_gl_upload_heap* heap = &((spel_gfx_context_gl*)ctx->data)->upload;
+	atomic_flag_clear(&heap->lock);
+	heap->thread = SDL_GetCurrentThreadID();
+	heap->size = SPEL_GL_UPLOAD_HEAP_SIZE;
+
+	GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	glCreateBuffers(1, &heap->buffer);
+	glNamedBufferStorage(heap->buffer, (GLsizeiptr)heap->size, NULL, flags);
+	heap->mapped = glMapNamedBufferRange(heap->buffer, 0, (GLsizeiptr)heap->size, flags);
+
+	// everything spills to the cpu heap then, slower but still correct
+	if (heap->mapped == NULL)
+	{
+		spel_warn("couldn't map the %zu byte upload heap, uploads go through the driver",
+				  heap->size);
+		glDeleteBuffers(1, &heap->buffer);
+		heap->buffer = 0;
+		heap->size = 0;
+	}
+}
+
+// moves the tail past every batch the gpu finished. with `wait`, blocks on the
+// oldest one first
+static void spel_gl_upload_retire(spel_gl_upload_heap* heap, bool wait)
+{
+	while (heap->batch_count > 0)
+	{
+		GLsync fence = heap->batches[heap->batch_first].fence;
+
+		GLenum status = glClientWaitSync(fence, 0, 0);
+		while (wait && status == GL_TIMEOUT_EXPIRED)
+		{
+			status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ULL);
+		}
+
+		if (status == GL_TIMEOUT_EXPIRED)
+		{
+			break;
+		}
+
+		glDeleteSync(fence);
+		heap->tail = heap->batches[heap->batch_first].end;
+		heap->batch_first = (heap->batch_first + 1) % SPEL_GL_UPLOAD_BATCHES;
+		heap->batch_count--;
+		wait = false;
+	}
+
+	if (heap->batch_count == 0 && heap->pending_count == 0)
+	{
+		heap->head = 0;
+		heap->tail = 0;
+	}
+}
+
+// head == tail only ever means empty, so a wrapped heap never fills to the last byte
+static bool spel_gl_upload_fits(spel_gl_upload_heap* heap, size_t size, size_t* offset)
+{
+	size_t start =
+		(heap->head + SPEL_GL_UPLOAD_ALIGN - 1) & ~(size_t)(SPEL_GL_UPLOAD_ALIGN - 1);
+
+	if (heap->head >= heap->tail)
+	{
+		if (start + size <= heap->size)
+		{
+			*offset = start;
+			return true;
+		}
+
+		if (size < heap->tail)
+		{
+			*offset = 0;
+			return true;
+		}
+
+		return false;
+	}
+
+	if (start + size < heap->tail)
+	{
+		*offset = start;
+		return true;
+	}
+
+	return false;
+}
+
+static void spel_gl_upload_flush_locked(spel_gfx_context ctx)
+{
+	spel_gl_upload_heap* heap = &((spel_gfx_context_gl*)ctx->data)->upload;
+	if (heap->pending_count == 0)
+	{
+		return;
+	}
+
+	bool staged = false;
+	bool unpack_bound = false;
+	bool drained = false;
+
+	for (uint32_t i = 0; i < heap->pending_count; i++)
+	{
+		spel_gl_upload* up = &heap->pending[i];
+
+		if (up->buf != NULL)
+		{
+			spel_gfx_gl_buffer* glBuf = (spel_gfx_gl_buffer*)up->buf->data;
+			GLuint dst = glBuf->buffer;
+			if (up->spill && glBuf->mapped)
+			{
+				// no dynamic storage to hand the driver a pointer, so wait until
+				// the gpu is done with the buffer and write the mapping. only
+				// happens when the heap couldn't take the upload
+				if (!drained)
+				{
+					glFinish();
+					drained = true;
+				}
+				memcpy((uint8_t*)glBuf->mapped + up->dst, up->spill, up->size);
+			}
+			else if (up->spill)
+			{
+				glNamedBufferSubData(dst, (GLintptr)up->dst, (GLsizeiptr)up->size,
+									 up->spill);
+			}
+			else
+			{
+				glCopyNamedBufferSubData(heap->buffer, dst, (GLintptr)up->src,
+										 (GLintptr)up->dst, (GLsizeiptr)up->size);
+			}
+		}
+		else
+		{
+			// a pbo source means the pointer is an offset into it, a spill needs
+			// the unpack binding cleared again
+			if (unpack_bound == (up->spill != NULL))
+			{
+				unpack_bound = up->spill == NULL;
+				glBindBuffer(GL_PIXEL_UNPACK_BUFFER, unpack_bound ? heap->buffer : 0);
+			}
+
+			const spel_gfx_gl_format_info* fmt = &GL_FORMATS[up->texture->format];
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+			glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+			glTextureSubImage2D(*(GLuint*)up->texture->data, (GLint)up->mip,
+								up->region.x, up->region.y, up->region.width,
+								up->region.height, fmt->external_format, fmt->type,
+								up->spill ? up->spill : (const void*)(uintptr_t)up->src);
+		}
+
+		if (up->spill)
+		{
+			spel_memory_free(up->spill);
+		}
+		else
+		{
+			staged = true;
+		}
+	}
+
+	if (unpack_bound)
+	{
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	}
+
+	heap->pending_count = 0;
+
+	if (!staged)
+	{
+		return;
+	}
+
+	if (heap->batch_count == SPEL_GL_UPLOAD_BATCHES)
+	{
+		spel_gl_upload_retire(heap, true);
+	}
+
+	uint32_t slot = (heap->batch_first + heap->batch_count) % SPEL_GL_UPLOAD_BATCHES;
+	heap->batches[slot].fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	heap->batches[slot].end = heap->head;
+	heap->batch_count++;
+}
+
+spel_hidden void spel_gl_upload_flush(spel_gfx_context ctx)
+{
+	spel_gl_upload_heap* heap = &((spel_gfx_context_gl*)ctx->data)->upload;
+
+	spel_gl_upload_lock(heap);
+	spel_gl_upload_flush_locked(ctx);
+	spel_gl_upload_retire(heap, false);
+	spel_gl_upload_unlock(heap);
+}
+
+// reserves staging space for `size` bytes and queues the upload, returns where
+// the caller copies the data to. called with the lock held
+static void* spel_gl_upload_queue(spel_gfx_context ctx, spel_gl_upload* up)
+{
+	spel_gl_upload_heap* heap = &((spel_gfx_context_gl*)ctx->data)->upload;
+	bool gl_thread = SDL_GetCurrentThreadID() == heap->thread;
+
+	if (heap->pending_count == heap->pending_cap)
+	{
+		heap->pending_cap = heap->pending_cap ? heap->pending_cap * 2 : 64;
+		heap->pending = spel_memory_realloc(
+			heap->pending, heap->pending_cap * sizeof(*heap->pending), SPEL_MEM_TAG_GFX);
+	}
+
+	up->spill = NULL;
+
+	// only the gl thread can make room, and nothing bigger than the heap ever fits
+	size_t offset = 0;
+	bool fits = false;
+	if (up->size < heap->size)
+	{
+		if (gl_thread)
+		{
+			spel_gl_upload_retire(heap, false);
+		}
+
+		fits = spel_gl_upload_fits(heap, up->size, &offset);
+		while (!fits && gl_thread && (heap->pending_count > 0 || heap->batch_count > 0))
+		{
+			if (heap->pending_count > 0)
+			{
+				spel_gl_upload_flush_locked(ctx);
+			}
+			spel_gl_upload_retire(heap, true);
+			fits = spel_gl_upload_fits(heap, up->size, &offset);
+		}
+	}
+
+	void* dst;
+	if (fits)
+	{
+		up->src = offset;
+		heap->head = offset + up->size;
+		dst = heap->mapped + offset;
+	}
+	else
+	{
+		up->spill = spel_memory_malloc(up->size, SPEL_MEM_TAG_GFX);
+		dst = up->spill;
+	}
+
+	heap->pending[heap->pending_count++] = *up;
+	return dst;
+}
+
+spel_hidden void spel_gl_upload_buffer(spel_gfx_buffer buf, const void* data, size_t size,
+									   size_t offset)
+{
+	spel_gl_upload_heap* heap = &((spel_gfx_context_gl*)buf->ctx->data)->upload;
+	spel_gl_upload up = {.buf = buf, .size = size, .dst = offset};
+
+	// copying under the lock keeps a flush from picking up a half written upload
+	spel_gl_upload_lock(heap);
+	memcpy(spel_gl_upload_queue(buf->ctx, &up), data, size);
+	spel_gl_upload_unlock(heap);
+}
+
+spel_hidden void spel_gl_upload_texture(spel_gfx_texture texture, uint32_t mip,
+										spel_rect region, const void* data,
+										size_t rowLength)
+{
+	spel_gl_upload_heap* heap = &((spel_gfx_context_gl*)texture->ctx->data)->upload;
+	size_t bpp = GL_FORMATS[texture->format].bytes_per_pixel;
+	size_t row = (size_t)region.width * bpp;
+
+	spel_gl_upload up = {.texture = texture,
+						 .size = row * (size_t)region.height,
+						 .mip = mip,
+						 .region = region};
+
+	// rows get packed tight on the way in, the flush uploads with no row length
+	spel_gl_upload_lock(heap);
+	uint8_t* dst = spel_gl_upload_queue(texture->ctx, &up);
+	for (int y = 0; y < region.height; y++)
+	{
+		memcpy(dst + (size_t)y * row, (const uint8_t*)data + (size_t)y * rowLength * bpp,
+			   row);
+	}
+	spel_gl_upload_unlock(heap);
+}
+
+spel_hidden void spel_gl_upload_shutdown(spel_gfx_context ctx)
+{
+	spel_gl_upload_heap* heap = &((spel_gfx_context_gl*)ctx->data)->upload;
+
+	spel_gl_upload_lock(heap);
+	spel_gl_upload_flush_locked(ctx);
+	while (heap->batch_count > 0)
+	{
+		spel_gl_upload_retire(heap, true);
+	}
+	spel_gl_upload_unlock(heap);
+
+	if (heap->buffer)
+	{
+		glDeleteBuffers(1, &heap->buffer);
+	}
+	spel_memory_free(heap->pending);
+	memset(heap, 0, sizeof(*heap));
+}
@@ -6,10 +6,14 @@ spel_gfx_vtable_t GL_VTABLE = {.ctx_destroy = spel_gfx_context_destroy_gl,
 							   .frame_begin = spel_gfx_frame_begin_gl,
 							   .frame_end = spel_gfx_frame_end_gl,
 
+							   .fence_insert = spel_gfx_fence_insert_gl,
+							   .fence_wait = spel_gfx_fence_wait_gl,
+
 							   .cmdlist_create = spel_gfx_cmdlist_create_gl,
 							   .cmdlist_destroy = spel_gfx_cmdlist_destroy_gl,
 							   .cmdlist_submit = spel_gfx_cmdlist_submit_gl,
 							   .cmdlist_alloc = spel_gfx_cmdlist_alloc_gl,
+							   .cmdlist_reset = spel_gfx_cmdlist_reset_gl,
 
 							   .buffer_create = spel_gfx_buffer_create_gl,
 							   .buffer_destroy = spel_gfx_buffer_destroy_gl,
@@ -23,6 +27,9 @@ spel_gfx_vtable_t GL_VTABLE = {.ctx_destroy = spel_gfx_context_destroy_gl,
 							   .shader_destroy = spel_gfx_shader_destroy_gl,
 
 							   .pipeline_create = spel_gfx_pipeline_create_gl,
+							   .pipeline_precompile = spel_gfx_pipeline_precompile_gl,
+							   .pipeline_ready = spel_gfx_pipeline_ready_gl,
+							   .pipeline_reload = spel_gfx_pipeline_reload_gl,
 							   .pipeline_destroy = spel_gfx_pipeline_destroy_gl,
 
 							   .texture_create = spel_gfx_texture_create_gl,
@@ -31,6 +38,8 @@ spel_gfx_vtable_t GL_VTABLE = {.ctx_destroy = spel_gfx_context_destroy_gl,
 							   .sampler_destroy = spel_gfx_sampler_destroy_gl,
 							   .texture_resize = spel_gfx_texture_resize_gl,
 							   .texture_update = spel_gfx_texture_update_gl,
+							   .texture_view = spel_gfx_texture_view_gl,
+							   .texture_replace = spel_gfx_texture_replace_gl,
 
 							   .framebuffer_create = spel_gfx_framebuffer_create_gl,
 							   .framebuffer_destroy = spel_gfx_framebuffer_destroy_gl,
@@ -13,7 +13,11 @@ spel_hidden void spel_gfx_context_conf_gl();
 spel_hidden void spel_gfx_frame_begin_gl(spel_gfx_context ctx);
 spel_hidden void spel_gfx_frame_end_gl(spel_gfx_context ctx);
 
+spel_hidden void* spel_gfx_fence_insert_gl(spel_gfx_context ctx);
+spel_hidden bool spel_gfx_fence_wait_gl(spel_gfx_context ctx, void* fence);
+
 spel_hidden void* spel_gfx_context_internal_handle_gl(spel_gfx_context ctx);
+spel_hidden void spel_gl_state_validate(spel_gfx_context_gl* gl, const char* where);
 
 spel_hidden void spel_gfx_debug_callback(unsigned int source, unsigned int type,
 									   unsigned int id, unsigned int severity, int length,
@@ -25,6 +29,7 @@ spel_hidden void spel_gfx_cmdlist_destroy_gl(spel_gfx_cmdlist cl);
 spel_hidden void spel_gfx_cmdlist_submit_gl(spel_gfx_cmdlist cl);
 
 spel_hidden void* spel_gfx_cmdlist_alloc_gl(spel_gfx_cmdlist cl, size_t size, size_t align);
+spel_hidden void spel_gfx_cmdlist_reset_gl(spel_gfx_cmdlist cl);
 
 // buffers
 spel_hidden spel_gfx_buffer spel_gfx_buffer_create_gl(spel_gfx_context ctx,
@@ -41,6 +46,19 @@ spel_hidden void spel_gfx_buffer_flush_gl(spel_gfx_buffer buf, size_t offset, si
 spel_hidden void spel_gfx_buffer_resize_gl(spel_gfx_buffer buf, size_t newSize,
 										 bool preserveData);
 
+// on-disk program binaries
+spel_hidden void spel_gl_program_binary_init(spel_gfx_context ctx);
+
+// staging uploads
+spel_hidden void spel_gl_upload_init(spel_gfx_context ctx);
+spel_hidden void spel_gl_upload_shutdown(spel_gfx_context ctx);
+spel_hidden void spel_gl_upload_flush(spel_gfx_context ctx);
+spel_hidden void spel_gl_upload_buffer(spel_gfx_buffer buf, const void* data, size_t size,
+									   size_t offset);
+spel_hidden void spel_gl_upload_texture(spel_gfx_texture texture, uint32_t mip,
+										spel_rect region, const void* data,
+										size_t rowLength);
+
 // shaders
 spel_hidden spel_gfx_shader spel_gfx_shader_create_gl(spel_gfx_context ctx,
 													spel_gfx_shader_desc* desc);
@@ -50,6 +68,11 @@ spel_hidden void spel_gfx_shader_destroy_gl(spel_gfx_shader shader);
 // pipelines
 spel_hidden spel_gfx_pipeline
 spel_gfx_pipeline_create_gl(spel_gfx_context ctx, const spel_gfx_pipeline_desc* desc);
+spel_hidden spel_gfx_pipeline
+spel_gfx_pipeline_precompile_gl(spel_gfx_context ctx, const spel_gfx_pipeline_desc* desc);
+spel_hidden bool spel_gfx_pipeline_ready_gl(spel_gfx_pipeline pipeline);
+spel_hidden bool spel_gfx_pipeline_reload_gl(spel_gfx_pipeline pipeline);
+spel_hidden void spel_gl_pipeline_resolve(spel_gfx_pipeline pipeline);
 
 spel_hidden void spel_gfx_pipeline_destroy_gl(spel_gfx_pipeline pipeline);
 
@@ -69,6 +92,9 @@ spel_hidden void spel_gfx_texture_resize_gl(spel_gfx_texture texture, uint32_t w
 
 spel_hidden void spel_gfx_texture_update_gl(spel_gfx_texture texture, uint32_t mip,
 										  spel_rect region, void* data, size_t dataSize);
+spel_hidden spel_gfx_texture spel_gfx_texture_view_gl(spel_gfx_texture source);
+spel_hidden bool spel_gfx_texture_replace_gl(spel_gfx_texture texture,
+											 const spel_gfx_texture_desc* desc);
 
 // framebuffers
 spel_hidden spel_gfx_framebuffer spel_gfx_framebuffer_create_gl(
@@ -1,8 +1,11 @@
 #ifndef SPEL_GFX_GL_TYPES
 #define SPEL_GFX_GL_TYPES
+#include "core/memory.h"
 #include "gfx/gfx_framebuffer.h"
+#include "gfx/gfx_internal.h"
 #include "gfx/gfx_types.h"
 #include "gl.h"
+#include <stdatomic.h>
 
 typedef struct
 {
@@ -15,6 +18,8 @@ typedef struct
 	GLuint vao;
 	uint64_t program_hash;
 	uint64_t vao_hash;
+	uint64_t state_hash; // everything but the program, rekeys the pipeline on reload
+	bool pending; // precompiled, the link hasn't been checked yet
 
 	// Points to shared stride array owned by VAO cache entry.
 	GLsizei* strides;
@@ -81,6 +86,7 @@ typedef struct
 {
 	GLuint buffer;
 	void* mirror;
+	void* mapped; // set for persistent buffers, mapped once for their whole life
 	uint32_t dirty_min;
 	uint32_t dirty_max;
 } spel_gfx_gl_buffer;
@@ -91,20 +97,238 @@ typedef struct
 	uint32_t draw_buffer_count;
 } spel_gfx_gl_framebuffer;
 
+typedef struct
+{
+	spel_gfx_pipeline pipeline;
+
+	spel_gfx_buffer index_buffer;
+	size_t index_offset;
+	GLenum index_type;
+
+	spel_gfx_sampler sampler;
+
+	spel_gfx_render_pass current_pass;
+	int target_height; // height of the current render target for Y-flip in
+					   // viewport/scissor
+} spel_gfx_cmdlist_gl;
+
+// handle and backend data share one pool slot, so `data` points right past the
+// handle and exec_cmd_* never chases a second allocation
+typedef struct
+{
+	spel_gfx_buffer_t handle;
+	spel_gfx_gl_buffer gl;
+} spel_gfx_buffer_slot_gl;
+
+typedef struct
+{
+	spel_gfx_texture_t handle;
+	GLuint gl;
+} spel_gfx_texture_slot_gl;
+
+typedef struct
+{
+	spel_gfx_sampler_t handle;
+	GLuint gl;
+} spel_gfx_sampler_slot_gl;
+
+typedef struct
+{
+	spel_gfx_pipeline_t handle;
+	spel_gfx_pipeline_gl gl;
+} spel_gfx_pipeline_slot_gl;
+
+typedef struct
+{
+	spel_gfx_cmdlist_t handle;
+	spel_gfx_cmdlist_gl gl;
+} spel_gfx_cmdlist_slot_gl;
+
 typedef struct SDL_GLContextState* SDL_GLContext;
 
+#define SPEL_GL_UPLOAD_HEAP_SIZE (8 * 1024 * 1024)
+#define SPEL_GL_UPLOAD_BATCHES 16
+
+// one queued upload, either into a buffer or a texture region. the source is the
+// staging heap, or `spill` when the heap had no room (or the caller wasn't on the
+// gl thread and couldn't wait for it)
+typedef struct
+{
+	spel_gfx_buffer buf;
+	spel_gfx_texture texture;
+
+	size_t src;
+	void* spill;
+	size_t size;
+
+	size_t dst;
+	uint32_t mip;
+	spel_rect region;
+} spel_gl_upload;
+
+// staging heap: a persistently mapped ring that buffer and texture updates copy
+// into, flushed as one pass of gpu-side copies. every flush is a batch fenced on
+// its own, the tail only moves past a batch once the gpu is done reading it
+typedef struct
+{
+	GLuint buffer;
+	uint8_t* mapped;
+	size_t size;
+	size_t head;
+	size_t tail;
+
+	struct
+	{
+		GLsync fence;
+		size_t end;
+	} batches[SPEL_GL_UPLOAD_BATCHES];
+	uint32_t batch_first;
+	uint32_t batch_count;
+
+	spel_gl_upload* pending;
+	uint32_t pending_count;
+	uint32_t pending_cap;
+
+	uint64_t thread; // the only thread allowed to issue gl calls (or wait on fences)
+	atomic_flag lock;
+} spel_gl_upload_heap;
+
+// render state the last pipeline bind left in gl, so the next bind only issues
+// the calls that differ. stencil and blend sub-state only gets set while the test
+// is on, the *_set flags say whether the cached values mean anything yet. a
+// zeroed struct means "nothing known"
+typedef struct
+{
+	bool valid; // false until a pipeline bind has set everything once
+	bool stencil_set;
+	bool blend_set;
+
+	bool depth_test;
+	bool depth_write;
+	bool depth_clamp;
+	GLenum depth_func;
+
+	bool stencil_test;
+	GLenum stencil_func;
+	GLint stencil_ref;
+	GLuint stencil_read_mask;
+	GLuint stencil_write_mask;
+	GLenum stencil_fail_op;
+	GLenum stencil_depth_op;
+	GLenum stencil_pass_op;
+
+	bool blend;
+	GLenum blend_src_rgb;
+	GLenum blend_dst_rgb;
+	GLenum blend_src_a;
+	GLenum blend_dst_a;
+	GLenum blend_op_rgb;
+	GLenum blend_op_a;
+	GLbitfield color_mask;
+
+	bool cull;
+	GLenum cull_mode;
+	GLenum front_face;
+
+	bool scissor_test;
+} spel_gl_render_state;
+
 typedef struct spel_gfx_context_gl
 {
 	SDL_GLContext ctx;
 	spel_gfx_pipeline pipeline;
 
+	// what gl has bound right now. the backend is the only one binding these, so
+	// nothing needs to ask the driver (glGet stalls on a lot of them).
+	// --gfx-validate cross-checks the shadow against the real thing
+	struct
+	{
+		GLuint program;
+		GLuint vao;
+		GLuint fbo;
+		GLuint indirect;
+		GLuint dispatch_indirect;
+	} bound;
+	spel_gl_render_state state;
+	bool validate_state;
+
 	struct
 	{
 		uint8_t major;
 		uint8_t minor;
 	} version;
+
+	struct
+	{
+		spel_memory_pool buffers;
+		spel_memory_pool textures;
+		spel_memory_pool samplers;
+		spel_memory_pool pipelines;
+		spel_memory_pool cmdlists;
+		spel_memory_pool cmd_chunks;
+	} pools;
+	atomic_flag chunk_lock;
+
+	spel_gl_upload_heap upload;
+
+	// binaries are only good for the exact driver that wrote them, so the
+	// vendor/renderer/version strings go into every cache key
+	struct
+	{
+		bool enabled;
+		uint64_t driver;
+	} program_binary;
+
+	// KHR_parallel_shader_compile, links run on driver threads
+	bool parallel_compile;
 } spel_gfx_context_gl;
 
+// shadowed binds, these only reach the driver when the binding actually changes
+static inline void spel_gl_use_program(spel_gfx_context_gl* gl, GLuint program)
+{
+	if (gl->bound.program != program)
+	{
+		glUseProgram(program);
+		gl->bound.program = program;
+	}
+}
+
+static inline void spel_gl_bind_vao(spel_gfx_context_gl* gl, GLuint vao)
+{
+	if (gl->bound.vao != vao)
+	{
+		glBindVertexArray(vao);
+		gl->bound.vao = vao;
+	}
+}
+
+static inline void spel_gl_bind_indirect(spel_gfx_context_gl* gl, GLuint buffer)
+{
+	if (gl->bound.indirect != buffer)
+	{
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, buffer);
+		gl->bound.indirect = buffer;
+	}
+}
+
+static inline void spel_gl_bind_dispatch_indirect(spel_gfx_context_gl* gl, GLuint buffer)
+{
+	if (gl->bound.dispatch_indirect != buffer)
+	{
+		glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, buffer);
+		gl->bound.dispatch_indirect = buffer;
+	}
+}
+
+static inline void spel_gl_bind_fbo(spel_gfx_context_gl* gl, GLuint fbo)
+{
+	if (gl->bound.fbo != fbo)
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+		gl->bound.fbo = fbo;
+	}
+}
+
 static const spel_gfx_gl_format_info GL_FORMATS[SPEL_GFX_TEXTURE_FORMAT_COUNT] = {
 	[SPEL_GFX_TEXTURE_FMT_R8_UNORM] = {GL_R8, GL_RED, GL_UNSIGNED_BYTE, 1, 0, 0, 0, 1},
 
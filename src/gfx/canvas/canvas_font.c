@@ -391,31 +391,38 @@ void spel_canvas_draw_text_internal(const char* text, spel_vec2 position, float
 	ctx->font_data.sdf_threshold = 0.5f;
 	ctx->font_data.mode = spel_font_mode(font);
 
-	if (spel.gfx->shaders[4] == NULL)
+	// one text shader per font mode, specialized so it doesn't branch per pixel
+	spel_gfx_shader* text_shader = &spel.gfx->shaders[4 + ctx->font_data.mode];
+	if (*text_shader == NULL)
 	{
+		spel_gfx_shader_constant mode = {.name = "TEXT_MODE",
+										 .value = (uint32_t)ctx->font_data.mode};
+
 		spel_gfx_shader_desc fragment_desc;
 		fragment_desc.shader_source = SPEL_GFX_SHADER_STATIC;
 		fragment_desc.debug_name = "spel_internal_text_frag";
 		fragment_desc.source = spel_internal_text_frag_spv;
 		fragment_desc.source_size = spel_internal_text_frag_spv_len;
+		fragment_desc.constants = &mode;
+		fragment_desc.constant_count = 1;
 
-		spel.gfx->shaders[4] = spel_gfx_shader_create(spel.gfx, &fragment_desc);
-		if (spel.gfx->shaders[4] != NULL)
+		*text_shader = spel_gfx_shader_create(spel.gfx, &fragment_desc);
+		if (*text_shader != NULL)
 		{
-			spel.gfx->shaders[4]->internal = true;
+			(*text_shader)->internal = true;
 		}
 	}
 
-	if (spel.gfx->shaders[4] == NULL)
+	if (*text_shader == NULL)
 	{
 		spel_error(SPEL_ERR_SHADER_FAILED, "failed to create internal text shader");
 		return;
 	}
 
 	spel_gfx_shader previous_fragment = ctx->pipeline_desc.fragment_shader;
-	if (ctx->pipeline_desc.fragment_shader != spel.gfx->shaders[4])
+	if (ctx->pipeline_desc.fragment_shader != *text_shader)
 	{
-		ctx->pipeline_desc.fragment_shader = spel.gfx->shaders[4];
+		ctx->pipeline_desc.fragment_shader = *text_shader;
 		ctx->pipeline_dirty = true;
 	}
 
@@ -439,13 +446,13 @@ void spel_canvas_draw_text_internal(const char* text, spel_vec2 position, float
 		ctx->sampler_desc.mag = mag;
 	}
 
-	if (ctx->font_ubuffer.buffer == NULL)
+	if (ctx->font_ubuffer.size == 0)
 	{
-		ctx->font_ubuffer = spel_gfx_uniform_buffer_create(ctx->pipeline, "DrawData");
-		if (ctx->font_ubuffer.buffer == NULL)
+		ctx->font_ubuffer = spel_gfx_uniform_block_get(ctx->pipeline, "DrawData");
+		if (ctx->font_ubuffer.size == 0)
 		{
 			spel_error(SPEL_ERR_INVALID_RESOURCE,
-					   "text draw skipped: failed to create DrawData buffer");
+					   "text draw skipped: DrawData block unavailable");
 			ctx->pipeline_desc.fragment_shader = previous_fragment;
 			return;
 		}
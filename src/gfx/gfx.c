@@ -38,10 +38,24 @@ spel_api void spel_gfx_context_conf(spel_gfx_backend backend)
 
 spel_api spel_gfx_context spel_gfx_context_create(spel_gfx_context_desc* desc)
 {
-	spel_gfx_context ctx = (spel_gfx_context)spel_memory_malloc(
-		sizeof(spel_gfx_context_t), SPEL_MEM_TAG_GFX);
+	spel_gfx_context ctx = (spel_gfx_context)spel_memory_calloc(
+		1, sizeof(spel_gfx_context_t), SPEL_MEM_TAG_GFX);
 	ctx->backend = desc->backend;
 	ctx->debug = desc->debug;
+	ctx->program_cache_dir = NULL;
+	if (desc->program_cache_dir != NULL)
+	{
+		ctx->program_cache_dir =
+			spel_memory_strdup(desc->program_cache_dir, SPEL_MEM_TAG_GFX);
+	}
+
+	ctx->shader_watch = NULL;
+	ctx->texture_loader = NULL;
+	ctx->texture_load_budget_ns = SPEL_GFX_TEXTURE_LOAD_BUDGET_NS;
+	if (desc->shader_hot_reload)
+	{
+		spel_gfx_shader_watch_init(ctx);
+	}
 
 	spel_vec2 fb = spel_window_framebuffer_size();
 	ctx->fb_width = (int)fb.x;
@@ -82,6 +96,7 @@ spel_api spel_gfx_context spel_gfx_context_create(spel_gfx_context_desc* desc)
 	if (ctx->vt == NULL)
 	{
 		spel_error(SPEL_ERR_CONTEXT_FAILED, "backend creation failed");
+		spel_memory_free(ctx->program_cache_dir);
 		spel_memory_free(ctx);
 		return NULL;
 	}
@@ -91,8 +106,8 @@ spel_api spel_gfx_context spel_gfx_context_create(spel_gfx_context_desc* desc)
 
 	ctx->canvas_ctx = NULL;
 
-	ctx->tracked_fbos = (spel_gfx_framebuffer*)spel_memory_malloc(
-		ctx->tracked_fbo_cap * sizeof(*ctx->tracked_fbos), SPEL_MEM_TAG_GFX);
+	ctx->tracked_fbos = (spel_gfx_framebuffer*)spel_memory_calloc(
+		ctx->tracked_fbo_cap, sizeof(*ctx->tracked_fbos), SPEL_MEM_TAG_GFX);
 
 	spel_gfx_context_default_data(ctx);
 
@@ -106,6 +121,8 @@ spel_api void spel_gfx_context_destroy(spel_gfx_context ctx)
 		spel_canvas_ctx_destroy(ctx->canvas_ctx);
 	}
 
+	spel_gfx_texture_loader_shutdown(ctx);
+
 	for (size_t i = 0; i < spel_array_size(ctx->shaders); i++)
 	{
 		if (ctx->shaders[i] == NULL)
@@ -145,19 +162,88 @@ spel_api void spel_gfx_context_destroy(spel_gfx_context ctx)
 	spel_gfx_texture_destroy(ctx->white_tex);
 	spel_gfx_texture_destroy(ctx->checkerboard);
 
+	if (ctx->uniform_ring != NULL)
+	{
+		spel_gfx_ring_destroy(ctx->uniform_ring);
+	}
+
+	while (ctx->rings != NULL)
+	{
+		spel_warn("ring %p was never destroyed", (void*)ctx->rings);
+		spel_gfx_ring_destroy(ctx->rings);
+	}
+
+	for (uint32_t i = 0; i < SPEL_GFX_FRAMES_IN_FLIGHT; i++)
+	{
+		if (ctx->frame_fences[i] != NULL)
+		{
+			ctx->vt->fence_wait(ctx, ctx->frame_fences[i]);
+		}
+	}
+
 	spel_gfx_cmdlist_destroy(ctx->cmdlist);
 	spel_gfx_render_pass_destroy(ctx->default_pass);
 	spel_memory_free((void*)ctx->tracked_fbos);
 	spel_memory_free(ctx->pipeline_cache.entries);
 	spel_memory_free(ctx->sampler_cache.entries);
 
+	spel_gfx_shader_watch_shutdown(ctx);
 	ctx->vt->ctx_destroy(ctx);
+	spel_memory_free(ctx->program_cache_dir);
 	spel_memory_free(ctx);
 }
 
+static void spel_gfx_ring_frame_begin(spel_gfx_ring ring)
+{
+	ring->head = 0;
+
+	spel_gfx_ring_retired** link = &ring->retired;
+	while (*link != NULL)
+	{
+		spel_gfx_ring_retired* retired = *link;
+		if (retired->slot != ring->ctx->frame_slot)
+		{
+			link = &retired->next;
+			continue;
+		}
+
+		*link = retired->next;
+		spel_gfx_buffer_destroy(retired->buffer);
+		spel_memory_free(retired);
+	}
+}
+
 spel_api void spel_gfx_frame_begin(spel_gfx_context ctx)
 {
+	ctx->last_stats = ctx->stats;
+	memset(&ctx->stats, 0, sizeof(ctx->stats));
+
+	// the slot's regions go back to the rings once the gpu is through with the frame
+	// that last wrote them
+	ctx->frame_slot = (ctx->frame_slot + 1) % SPEL_GFX_FRAMES_IN_FLIGHT;
+	void* fence = ctx->frame_fences[ctx->frame_slot];
+	if (fence != NULL)
+	{
+		if (ctx->vt->fence_wait(ctx, fence))
+		{
+			ctx->stats.fence_stalls++;
+		}
+		ctx->frame_fences[ctx->frame_slot] = NULL;
+	}
+
+	for (spel_gfx_ring ring = ctx->rings; ring != NULL; ring = ring->next)
+	{
+		spel_gfx_ring_frame_begin(ring);
+	}
+
 	ctx->vt->frame_begin(ctx);
+	spel_gfx_shader_watch_poll(ctx);
+	spel_gfx_texture_loader_poll(ctx);
+}
+
+spel_api spel_gfx_frame_stats spel_gfx_frame_stats_get(spel_gfx_context ctx)
+{
+	return ctx->last_stats;
 }
 
 spel_api void spel_gfx_frame_present(spel_gfx_context ctx)
@@ -166,22 +252,227 @@ spel_api void spel_gfx_frame_present(spel_gfx_context ctx)
 	{
 		spel_gfx_cmdlist_submit(ctx->canvas_ctx->command_list);
 	}
+
+	// presenting twice without a frame begin in between keeps the later fence
+	if (ctx->frame_fences[ctx->frame_slot] != NULL)
+	{
+		ctx->vt->fence_wait(ctx, ctx->frame_fences[ctx->frame_slot]);
+	}
+	ctx->frame_fences[ctx->frame_slot] = ctx->vt->fence_insert(ctx);
+
 	ctx->vt->frame_end(ctx);
 }
 
+static void spel_gfx_cmdlist_state_reset(spel_gfx_cmdlist cl)
+{
+	memset(&cl->state, 0, sizeof(cl->state));
+}
+
+// drops the tracked binds but keeps what the list knows about its passes
+static void spel_gfx_cmdlist_state_forget_binds(spel_gfx_cmdlist cl)
+{
+	spel_gfx_cmdlist_state kept = cl->state;
+
+	memset(&cl->state, 0, sizeof(cl->state));
+	cl->state.pass_index = kept.pass_index;
+	cl->state.sort_depth = kept.sort_depth;
+	cl->state.in_pass = kept.in_pass;
+	cl->state.opens_pass = kept.opens_pass;
+	cl->state.epoch = kept.epoch;
+}
+
+// forgets every tracked bind once something got destroyed since they were made,
+// the handle compares can't tell a reused slot from the old object
+static void spel_gfx_cmdlist_state_sync(spel_gfx_cmdlist cl)
+{
+	uint32_t epoch = atomic_load_explicit(&cl->ctx->resource_epoch, memory_order_relaxed);
+	if (cl->state.epoch == epoch)
+	{
+		return;
+	}
+
+	spel_gfx_cmdlist_state_forget_binds(cl);
+	cl->state.epoch = epoch;
+}
+
+static void spel_gfx_resource_retired(spel_gfx_context ctx)
+{
+	atomic_fetch_add_explicit(&ctx->resource_epoch, 1, memory_order_relaxed);
+}
+
 spel_api spel_gfx_cmdlist spel_gfx_cmdlist_create(spel_gfx_context ctx)
 {
-	return ctx->vt->cmdlist_create(ctx);
+	spel_gfx_cmdlist cl = ctx->vt->cmdlist_create(ctx);
+	if (cl)
+	{
+		spel_gfx_cmdlist_state_reset(cl);
+	}
+	return cl;
+}
+
+spel_api spel_gfx_cmdlist spel_gfx_cmdlist_create_secondary(spel_gfx_context ctx)
+{
+	spel_gfx_cmdlist cl = spel_gfx_cmdlist_create(ctx);
+	if (cl)
+	{
+		cl->secondary = true;
+	}
+	return cl;
+}
+
+spel_api spel_gfx_cmdlist spel_gfx_cmdlist_create_bundle(spel_gfx_context ctx)
+{
+	spel_gfx_cmdlist cl = spel_gfx_cmdlist_create_secondary(ctx);
+	if (cl)
+	{
+		cl->bundle = true;
+	}
+	return cl;
+}
+
+spel_api void spel_gfx_cmdlist_reset(spel_gfx_cmdlist cmdlist)
+{
+	for (uint32_t i = 0; i < cmdlist->secondary_count; i++)
+	{
+		cmdlist->ctx->vt->cmdlist_reset(cmdlist->secondaries[i]);
+		spel_gfx_cmdlist_state_reset(cmdlist->secondaries[i]);
+	}
+	cmdlist->secondary_count = 0;
+
+	cmdlist->ctx->vt->cmdlist_reset(cmdlist);
+	spel_gfx_cmdlist_state_reset(cmdlist);
 }
 
 spel_api void spel_gfx_cmdlist_destroy(spel_gfx_cmdlist cmdlist)
 {
+	spel_memory_free((void*)cmdlist->secondaries);
 	cmdlist->ctx->vt->cmdlist_destroy(cmdlist);
 }
 
 spel_api void spel_gfx_cmdlist_submit(spel_gfx_cmdlist cmdlist)
 {
+	if (cmdlist->secondary && !cmdlist->bundle)
+	{
+		spel_error(SPEL_ERR_INVALID_STATE,
+				   "secondary command lists run through spel_gfx_cmd_execute, not submit");
+		return;
+	}
+
 	cmdlist->ctx->vt->cmdlist_submit(cmdlist);
+
+	// a bundle replays from its first command every time, what it recorded stays
+	// valid no matter what ran in between
+	if (cmdlist->bundle)
+	{
+		return;
+	}
+
+	// whatever runs between now and the next submit can touch gl state, so the
+	// next recording has to start from scratch
+	spel_gfx_cmdlist_state_reset(cmdlist);
+
+	for (uint32_t i = 0; i < cmdlist->secondary_count; i++)
+	{
+		cmdlist->ctx->vt->cmdlist_reset(cmdlist->secondaries[i]);
+		spel_gfx_cmdlist_state_reset(cmdlist->secondaries[i]);
+	}
+	cmdlist->secondary_count = 0;
+}
+
+spel_api void spel_gfx_cmd_execute(spel_gfx_cmdlist cl, spel_gfx_cmdlist secondary)
+{
+	if (cl->secondary || !secondary->secondary)
+	{
+		spel_error(SPEL_ERR_INVALID_ARGUMENT,
+				   "only a secondary command list can be executed, and only from a primary");
+		return;
+	}
+
+	// passes don't nest, a bundle with its own pass has to run between them
+	if (cl->state.in_pass && secondary->state.opens_pass)
+	{
+		spel_error(SPEL_ERR_INVALID_STATE,
+				   "the executed list begins its own pass, it can't run inside one");
+		return;
+	}
+
+	// bundles keep their commands, only plain secondaries get reset on submit
+	if (!secondary->bundle)
+	{
+		if (cl->secondary_count == cl->secondary_cap)
+		{
+			uint32_t cap = cl->secondary_cap ? cl->secondary_cap * 2 : 4;
+			spel_gfx_cmdlist* secondaries = (spel_gfx_cmdlist*)spel_memory_realloc(
+				(void*)cl->secondaries, cap * sizeof(*secondaries), SPEL_MEM_TAG_GFX);
+			if (!secondaries)
+			{
+				spel_error(SPEL_ERR_OOM, "failed to grow the secondary command list array");
+				return;
+			}
+
+			cl->secondaries = secondaries;
+			cl->secondary_cap = cap;
+		}
+		cl->secondaries[cl->secondary_count++] = secondary;
+	}
+
+	uint64_t start_offset = cl->offset;
+	spel_gfx_execute_cmd* cmd = (spel_gfx_execute_cmd*)cl->ctx->vt->cmdlist_alloc(
+		cl, sizeof(*cmd), _Alignof(spel_gfx_execute_cmd));
+
+	cmd->hdr.type = SPEL_GFX_CMD_EXECUTE;
+	cmd->hdr.size = cl->offset - start_offset;
+	cmd->list = secondary;
+
+	// the secondary leaves gl however it wants, nothing the recorder knew about
+	// bound state holds anymore
+	spel_gfx_cmdlist_state_forget_binds(cl);
+}
+
+spel_api uint32_t spel_gfx_cmdlist_chunk_peak(spel_gfx_cmdlist cmdlist)
+{
+	return cmdlist->chunk_peak;
+}
+
+spel_api void spel_gfx_cmdlist_set_sorted(spel_gfx_cmdlist cmdlist, bool sorted)
+{
+	cmdlist->sorted = sorted;
+}
+
+spel_api void spel_gfx_cmd_sort_depth(spel_gfx_cmdlist cl, float depth)
+{
+	cl->state.sort_depth = depth;
+}
+
+// [pass:8][blended:1][pipeline:15][texture:16][depth:24], opaque draws group by
+// pipeline then texture and go front to back. blended draws only get the pass,
+// the backend sort is stable so they replay in recording order
+static uint64_t spel_gfx_cmdlist_sort_key(spel_gfx_cmdlist cl)
+{
+	if (!cl->sorted)
+	{
+		return 0;
+	}
+
+	spel_gfx_cmdlist_state* state = &cl->state;
+	uint64_t key = (uint64_t)(state->pass_index & 0xFF) << 56;
+
+	if (state->pipeline == NULL || state->pipeline->blended)
+	{
+		return key | (1ULL << 55);
+	}
+
+	uint64_t texture = (uint64_t)(uintptr_t)state->textures[0];
+	texture ^= texture >> 16;
+	texture ^= texture >> 32;
+
+	// flip the float so it sorts as an unsigned integer
+	uint32_t depth;
+	memcpy(&depth, &state->sort_depth, sizeof(depth));
+	depth = (depth & 0x80000000U) ? ~depth : depth | 0x80000000U;
+
+	return key | ((state->pipeline->hash & 0x7FFF) << 40) | ((texture & 0xFFFF) << 24) |
+		   (depth >> 8);
 }
 
 spel_api spel_gfx_buffer spel_gfx_buffer_create(spel_gfx_context ctx,
@@ -192,6 +483,7 @@ spel_api spel_gfx_buffer spel_gfx_buffer_create(spel_gfx_context ctx,
 
 spel_api void spel_gfx_buffer_destroy(spel_gfx_buffer buf)
 {
+	spel_gfx_resource_retired(buf->ctx);
 	buf->ctx->vt->buffer_destroy(buf);
 }
 
@@ -212,6 +504,149 @@ spel_api void spel_gfx_buffer_unmap(spel_gfx_buffer buf)
 	buf->ctx->vt->buffer_unmap(buf);
 }
 
+static spel_gfx_buffer spel_gfx_ring_buffer_create(spel_gfx_ring ring, size_t regionSize)
+{
+	spel_gfx_buffer_desc desc = {.type = ring->type,
+								 .usage = SPEL_GFX_USAGE_STREAM,
+								 .access = SPEL_GFX_BUFFER_DRAW,
+								 .persistent = true,
+								 .size = regionSize * SPEL_GFX_FRAMES_IN_FLIGHT,
+								 .data = NULL};
+
+	spel_gfx_buffer buffer = spel_gfx_buffer_create(ring->ctx, &desc);
+	if (buffer == NULL)
+	{
+		return NULL;
+	}
+
+	spel_gfx_access access =
+		spel_gfx_access_write | spel_gfx_access_persistent | spel_gfx_access_coherent;
+	uint8_t* mapped = spel_gfx_buffer_map(buffer, 0, desc.size, access);
+	if (mapped == NULL)
+	{
+		spel_gfx_buffer_destroy(buffer);
+		return NULL;
+	}
+
+	// only touches the ring once everything worked, a failed grow keeps the old one
+	ring->buffer = buffer;
+	ring->region_size = regionSize;
+	ring->mapped = mapped;
+	return buffer;
+}
+
+spel_api spel_gfx_ring spel_gfx_ring_create(spel_gfx_context ctx,
+											spel_gfx_buffer_type type, size_t frameSize)
+{
+	spel_gfx_ring ring = spel_memory_calloc(1, sizeof(*ring), SPEL_MEM_TAG_GFX);
+	if (ring == NULL)
+	{
+		spel_error(SPEL_ERR_OOM, "failed to allocate ring");
+		return NULL;
+	}
+
+	ring->ctx = ctx;
+	ring->type = type;
+
+	// regions start at multiples of their size, so rounding the size keeps every
+	// region on the driver's offset alignment too
+	size_t align = ctx->uniform_align > SPEL_GFX_RING_ALIGN ? ctx->uniform_align
+															: SPEL_GFX_RING_ALIGN;
+	size_t region = (frameSize + align - 1) & ~(align - 1);
+	if (spel_gfx_ring_buffer_create(ring, region ? region : align) == NULL)
+	{
+		spel_error(SPEL_ERR_OOM, "failed to create a %zu byte ring buffer",
+				   region * SPEL_GFX_FRAMES_IN_FLIGHT);
+		spel_memory_free(ring);
+		return NULL;
+	}
+
+	ring->next = ctx->rings;
+	ctx->rings = ring;
+	return ring;
+}
+
+spel_api void spel_gfx_ring_destroy(spel_gfx_ring ring)
+{
+	spel_gfx_ring* link = &ring->ctx->rings;
+	while (*link != ring)
+	{
+		link = &(*link)->next;
+	}
+	*link = ring->next;
+
+	// gl keeps deleted buffers alive for the commands still using them
+	while (ring->retired != NULL)
+	{
+		spel_gfx_ring_retired* retired = ring->retired;
+		ring->retired = retired->next;
+		spel_gfx_buffer_destroy(retired->buffer);
+		spel_memory_free(retired);
+	}
+
+	spel_gfx_buffer_destroy(ring->buffer);
+	spel_memory_free(ring);
+}
+
+static bool spel_gfx_ring_grow(spel_gfx_ring ring, size_t needed)
+{
+	spel_gfx_buffer old = ring->buffer;
+	size_t region = ring->region_size * 2;
+	while (region < needed)
+	{
+		region *= 2;
+	}
+
+	// commands recorded this frame still point into the old buffer
+	spel_gfx_ring_retired* retired =
+		spel_memory_malloc(sizeof(*retired), SPEL_MEM_TAG_GFX);
+	if (retired == NULL)
+	{
+		return false;
+	}
+
+	if (spel_gfx_ring_buffer_create(ring, region) == NULL)
+	{
+		spel_memory_free(retired);
+		return false;
+	}
+
+	retired->buffer = old;
+	retired->slot = ring->ctx->frame_slot;
+	retired->next = ring->retired;
+	ring->retired = retired;
+
+	ring->head = 0;
+	spel_debug("ring grew to %zu bytes per frame", region);
+	return true;
+}
+
+spel_api spel_gfx_ring_slice spel_gfx_ring_alloc(spel_gfx_ring ring, size_t size,
+												 size_t align)
+{
+	if (align == 0)
+	{
+		align = 1;
+	}
+
+	size_t offset = (ring->head + align - 1) & ~(align - 1);
+	if (offset + size > ring->region_size)
+	{
+		if (!spel_gfx_ring_grow(ring, size))
+		{
+			spel_error(SPEL_ERR_OOM, "ring out of space for a %zu byte slice", size);
+			return (spel_gfx_ring_slice){0};
+		}
+		offset = 0;
+	}
+
+	ring->head = offset + size;
+
+	size_t base = ((size_t)ring->ctx->frame_slot * ring->region_size) + offset;
+	return (spel_gfx_ring_slice){
+		.buffer = ring->buffer, .offset = base, .data = ring->mapped + base};
+}
+
 spel_api spel_gfx_shader spel_gfx_shader_create(spel_gfx_context ctx,
 												spel_gfx_shader_desc* desc)
 {
@@ -220,6 +655,7 @@ spel_api spel_gfx_shader spel_gfx_shader_create(spel_gfx_context ctx,
 
 spel_api void spel_gfx_shader_destroy(spel_gfx_shader shader)
 {
+	spel_gfx_shader_watch_remove(shader);
 	shader->ctx->vt->shader_destroy(shader);
 }
 
@@ -255,18 +691,24 @@ spel_hidden void spel_gfx_shader_reflection_free(spel_gfx_shader shader)
 		spel_memory_free(sampler->name);
 	}
 
+	for (uint32_t j = 0; j < refl->constant_count; j++)
+	{
+		spel_memory_free(refl->constants[j].name);
+	}
+
+	spel_memory_free(refl->constants);
 	spel_memory_free(refl->samplers);
 	spel_memory_free(refl->uniforms);
 	spel_memory_free(refl->storage);
 }
 
-spel_api spel_gfx_shader spel_gfx_shader_load(spel_gfx_context ctx, const char* path)
+static bool spel_gfx_shader_read(const char* path, spel_gfx_shader_desc* desc)
 {
 	if (!spel_path_exists(path))
 	{
 		spel_log(SPEL_SEV_ERROR, SPEL_ERR_FILE_NOT_FOUND, path, SPEL_DATA_STRING,
 				 strlen(path), "file %s does not exist", path);
-		return NULL;
+		return false;
 	}
 
 	char* buffer = NULL;
@@ -286,16 +728,114 @@ spel_api spel_gfx_shader spel_gfx_shader_load(spel_gfx_context ctx, const char*
 		fclose(f);
 	}
 
+	desc->debug_name = spel_path_filename(path);
+	desc->source = buffer;
+	desc->source_size = length;
+	desc->shader_source = SPEL_GFX_SHADER_DYNAMIC;
+	desc->constants = NULL;
+	desc->constant_count = 0;
+	return true;
+}
+
+spel_api spel_gfx_shader spel_gfx_shader_load(spel_gfx_context ctx, const char* path)
+{
 	spel_gfx_shader_desc shader_desc;
-	shader_desc.debug_name = spel_path_filename(path);
-	shader_desc.source = buffer;
-	shader_desc.source_size = length;
-	shader_desc.shader_source = SPEL_GFX_SHADER_DYNAMIC;
+	if (!spel_gfx_shader_read(path, &shader_desc))
+	{
+		return NULL;
+	}
 
 	spel_gfx_shader shader = spel_gfx_shader_create(spel.gfx, &shader_desc);
+	if (shader != NULL)
+	{
+		spel_gfx_shader_watch_add(shader, path);
+	}
 	return shader;
 }
 
+static bool spel_gfx_pipeline_uses(spel_gfx_pipeline pipeline, spel_gfx_shader shader)
+{
+	return pipeline->vertex_shader == shader || pipeline->fragment_shader == shader ||
+		   pipeline->geometry_shader == shader || pipeline->compute_shader == shader;
+}
+
+// builds the new shader next to the old one and swaps their contents, so every
+// handle out there (pipelines, the caller's own) keeps pointing at the same
+// shader. a file that doesn't compile leaves the old shader running
+spel_hidden bool spel_gfx_shader_reload(spel_gfx_shader shader, const char* path)
+{
+	spel_gfx_context ctx = shader->ctx;
+
+	spel_gfx_shader_desc desc;
+	if (!spel_gfx_shader_read(path, &desc))
+	{
+		return false;
+	}
+
+	spel_gfx_shader fresh = ctx->vt->shader_create(ctx, &desc);
+	if (fresh == NULL)
+	{
+		spel_warn("%s failed to reload, keeping the old shader", path);
+		return false;
+	}
+
+	if (fresh->type != shader->type || fresh->hash == shader->hash)
+	{
+		if (fresh->type != shader->type)
+		{
+			spel_warn("%s changed its stage, it has to be loaded again", path);
+		}
+		ctx->vt->shader_destroy(fresh);
+		return false;
+	}
+
+	spel_gfx_shader_t old = *shader;
+	*shader = *fresh;
+	*fresh = old;
+	ctx->vt->shader_destroy(fresh);
+
+	// gathered first, relinking rekeys pipelines inside the cache being walked
+	spel_gfx_pipeline_cache* cache = &ctx->pipeline_cache;
+	spel_gfx_pipeline* affected = NULL;
+	uint32_t affected_count = 0;
+	if (cache->count > 0)
+	{
+		affected =
+			spel_memory_malloc(cache->count * sizeof(*affected), SPEL_MEM_TAG_GFX);
+	}
+
+	for (uint32_t i = 0; i < cache->capacity; i++)
+	{
+		spel_gfx_pipeline pipeline = cache->entries[i].pipeline;
+		if (pipeline != NULL && spel_gfx_pipeline_uses(pipeline, shader))
+		{
+			affected[affected_count++] = pipeline;
+		}
+	}
+
+	uint32_t failed = 0;
+	for (uint32_t i = 0; i < affected_count; i++)
+	{
+		if (!ctx->vt->pipeline_reload(affected[i]))
+		{
+			failed++;
+		}
+	}
+
+	spel_memory_free(affected);
+
+	if (failed > 0)
+	{
+		spel_warn("reloaded %s, %u of %u pipelines kept their old program", path, failed,
+				  affected_count);
+	}
+	else
+	{
+		spel_debug("reloaded %s, relinked %u pipelines", path, affected_count);
+	}
+	return true;
+}
+
 spel_api void spel_gfx_cmd_clear(spel_gfx_cmdlist cl, spel_color color)
 {
 	uint64_t start_offset = cl->offset;
@@ -307,9 +847,52 @@ spel_api void spel_gfx_cmd_clear(spel_gfx_cmdlist cl, spel_color color)
 	cmd->color = color;
 }
 
+// vertex and index bindings live on a graphics pipeline's vao, a compute one has
+// neither. the same caveat as spel_gfx_cmd_check_compute applies
+static bool spel_gfx_cmd_check_graphics(spel_gfx_cmdlist cl)
+{
+	if (cl->state.pipeline && cl->state.pipeline->type == SPEL_GFX_PIPELINE_COMPUTE)
+	{
+		spel_error(SPEL_ERR_INVALID_STATE,
+				   "drawing needs a graphics pipeline bound, not a compute one");
+		return false;
+	}
+
+	return true;
+}
+
 spel_api void spel_gfx_cmd_bind_vertex(spel_gfx_cmdlist cl, uint32_t stream,
 									   spel_gfx_buffer buf, size_t offset)
 {
+	if (buf == NULL)
+	{
+		spel_error(SPEL_ERR_INVALID_ARGUMENT, "cannot bind a null vertex buffer");
+		return;
+	}
+
+	if (!spel_gfx_cmd_check_graphics(cl))
+	{
+		return;
+	}
+
+	if (buf->type != SPEL_GFX_BUFFER_VERTEX)
+	{
+		spel_warn("buffer type does not correspond to binding cmd (vertex). this is "
+				  "allowed, but discouraged");
+	}
+
+	spel_gfx_cmdlist_state_sync(cl);
+	if (stream < SPEL_GFX_CMDLIST_TRACKED_STREAMS)
+	{
+		if (cl->state.vertex[stream].buf == buf && cl->state.vertex[stream].offset == offset)
+		{
+			return;
+		}
+
+		cl->state.vertex[stream].buf = buf;
+		cl->state.vertex[stream].offset = offset;
+	}
+
 	uint64_t start_offset = cl->offset;
 	spel_gfx_bind_vertex_cmd* cmd = (spel_gfx_bind_vertex_cmd*)cl->ctx->vt->cmdlist_alloc(
 		cl, sizeof(*cmd), _Alignof(spel_gfx_bind_vertex_cmd));
@@ -324,6 +907,34 @@ spel_api void spel_gfx_cmd_bind_vertex(spel_gfx_cmdlist cl, uint32_t stream,
 spel_api void spel_gfx_cmd_bind_index(spel_gfx_cmdlist cl, spel_gfx_buffer buf,
 									  spel_gfx_index_type type, size_t offset)
 {
+	if (buf == NULL)
+	{
+		spel_error(SPEL_ERR_INVALID_ARGUMENT, "cannot bind a null index buffer");
+		return;
+	}
+
+	if (!spel_gfx_cmd_check_graphics(cl))
+	{
+		return;
+	}
+
+	if (buf->type != SPEL_GFX_BUFFER_INDEX)
+	{
+		spel_warn("buffer type does not correspond to binding cmd (index). this is "
+				  "allowed, but discouraged");
+	}
+
+	spel_gfx_cmdlist_state_sync(cl);
+	if (cl->state.index.buf == buf && cl->state.index.offset == offset &&
+		cl->state.index.type == type)
+	{
+		return;
+	}
+
+	cl->state.index.buf = buf;
+	cl->state.index.offset = offset;
+	cl->state.index.type = type;
+
 	uint64_t start_offset = cl->offset;
 	spel_gfx_bind_index_cmd* cmd = (spel_gfx_bind_index_cmd*)cl->ctx->vt->cmdlist_alloc(
 		cl, sizeof(*cmd), _Alignof(spel_gfx_bind_index_cmd));
@@ -337,6 +948,25 @@ spel_api void spel_gfx_cmd_bind_index(spel_gfx_cmdlist cl, spel_gfx_buffer buf,
 
 spel_api void spel_gfx_cmd_bind_pipeline(spel_gfx_cmdlist cl, spel_gfx_pipeline pipeline)
 {
+	if (pipeline == NULL)
+	{
+		spel_error(SPEL_ERR_INVALID_ARGUMENT, "cannot bind a null pipeline");
+		return;
+	}
+
+	spel_gfx_cmdlist_state_sync(cl);
+	if (cl->state.pipeline == pipeline)
+	{
+		return;
+	}
+
+	// vertex/index bindings live on the pipeline's vao and shader buffer locations
+	// are resolved through its reflection, so those don't carry over
+	cl->state.pipeline = pipeline;
+	memset(cl->state.vertex, 0, sizeof(cl->state.vertex));
+	memset(&cl->state.index, 0, sizeof(cl->state.index));
+	cl->state.shader_buffer_count = 0;
+
 	uint64_t start_offset = cl->offset;
 	spel_gfx_bind_pipeline_cmd* cmd =
 		(spel_gfx_bind_pipeline_cmd*)cl->ctx->vt->cmdlist_alloc(
@@ -350,12 +980,18 @@ spel_api void spel_gfx_cmd_bind_pipeline(spel_gfx_cmdlist cl, spel_gfx_pipeline
 spel_api void spel_gfx_cmd_draw(spel_gfx_cmdlist cl, uint32_t vertexCount,
 								uint32_t firstVertex)
 {
+	if (!spel_gfx_cmd_check_graphics(cl))
+	{
+		return;
+	}
+
 	uint64_t start_offset = cl->offset;
 	spel_gfx_draw_cmd* cmd = (spel_gfx_draw_cmd*)cl->ctx->vt->cmdlist_alloc(
 		cl, sizeof(*cmd), _Alignof(spel_gfx_draw_cmd));
 
 	cmd->hdr.type = SPEL_GFX_CMD_DRAW;
 	cmd->hdr.size = cl->offset - start_offset;
+	cmd->sort_key = spel_gfx_cmdlist_sort_key(cl);
 	cmd->vertex_count = vertexCount;
 	cmd->first_vertex = firstVertex;
 }
@@ -363,6 +999,11 @@ spel_api void spel_gfx_cmd_draw(spel_gfx_cmdlist cl, uint32_t vertexCount,
 spel_api void spel_gfx_cmd_draw_indexed(spel_gfx_cmdlist cl, uint32_t indexCount,
 										uint32_t firstIndex, int32_t vertexOffset)
 {
+	if (!spel_gfx_cmd_check_graphics(cl))
+	{
+		return;
+	}
+
 	uint64_t start_offset = cl->offset;
 	spel_gfx_draw_indexed_cmd* cmd =
 		(spel_gfx_draw_indexed_cmd*)cl->ctx->vt->cmdlist_alloc(
@@ -370,9 +1011,247 @@ spel_api void spel_gfx_cmd_draw_indexed(spel_gfx_cmdlist cl, uint32_t indexCount
 
 	cmd->hdr.type = SPEL_GFX_CMD_DRAW_INDEXED;
 	cmd->hdr.size = cl->offset - start_offset;
+	cmd->sort_key = spel_gfx_cmdlist_sort_key(cl);
+	cmd->index_count = indexCount;
+	cmd->first_index = firstIndex;
+	cmd->vertex_offset = vertexOffset;
+}
+
+spel_api void spel_gfx_cmd_draw_instanced(spel_gfx_cmdlist cl, uint32_t vertexCount,
+										  uint32_t instanceCount, uint32_t firstVertex,
+										  uint32_t firstInstance)
+{
+	if (instanceCount == 0 || !spel_gfx_cmd_check_graphics(cl))
+	{
+		return;
+	}
+
+	uint64_t start_offset = cl->offset;
+	spel_gfx_draw_instanced_cmd* cmd =
+		(spel_gfx_draw_instanced_cmd*)cl->ctx->vt->cmdlist_alloc(
+			cl, sizeof(*cmd), _Alignof(spel_gfx_draw_instanced_cmd));
+
+	cmd->hdr.type = SPEL_GFX_CMD_DRAW_INSTANCED;
+	cmd->hdr.size = cl->offset - start_offset;
+	cmd->sort_key = spel_gfx_cmdlist_sort_key(cl);
+	cmd->vertex_count = vertexCount;
+	cmd->first_vertex = firstVertex;
+	cmd->instance_count = instanceCount;
+	cmd->first_instance = firstInstance;
+}
+
+spel_api void spel_gfx_cmd_draw_indexed_instanced(spel_gfx_cmdlist cl,
+												  uint32_t indexCount,
+												  uint32_t instanceCount,
+												  uint32_t firstIndex,
+												  int32_t vertexOffset,
+												  uint32_t firstInstance)
+{
+	if (instanceCount == 0 || !spel_gfx_cmd_check_graphics(cl))
+	{
+		return;
+	}
+
+	uint64_t start_offset = cl->offset;
+	spel_gfx_draw_indexed_instanced_cmd* cmd =
+		(spel_gfx_draw_indexed_instanced_cmd*)cl->ctx->vt->cmdlist_alloc(
+			cl, sizeof(*cmd), _Alignof(spel_gfx_draw_indexed_instanced_cmd));
+
+	cmd->hdr.type = SPEL_GFX_CMD_DRAW_INDEXED_INSTANCED;
+	cmd->hdr.size = cl->offset - start_offset;
+	cmd->sort_key = spel_gfx_cmdlist_sort_key(cl);
 	cmd->index_count = indexCount;
 	cmd->first_index = firstIndex;
 	cmd->vertex_offset = vertexOffset;
+	cmd->instance_count = instanceCount;
+	cmd->first_instance = firstInstance;
+}
+
+static void spel_gfx_cmd_draw_indirect_record(spel_gfx_cmdlist cl, spel_gfx_cmd_type type,
+											  spel_gfx_buffer buf, size_t offset,
+											  uint32_t drawCount, uint32_t stride,
+											  size_t argsSize)
+{
+	if (buf == NULL)
+	{
+		spel_error(SPEL_ERR_INVALID_ARGUMENT, "indirect draws need an argument buffer");
+		return;
+	}
+
+	if (drawCount == 0 || !spel_gfx_cmd_check_graphics(cl))
+	{
+		return;
+	}
+
+	if (buf->type != SPEL_GFX_BUFFER_INDIRECT)
+	{
+		spel_warn("buffer type does not correspond to binding cmd (indirect). this is "
+				  "allowed, but discouraged");
+	}
+
+	// the arguments carry their own first index, the bound index offset can't be
+	// folded in the way indexed draws do it
+	if (type == SPEL_GFX_CMD_DRAW_INDEXED_INDIRECT && cl->state.index.offset != 0)
+	{
+		spel_warn("indexed indirect draws ignore the offset the index buffer was bound "
+				  "with (%zu)",
+				  cl->state.index.offset);
+	}
+
+	if (stride == 0)
+	{
+		stride = (uint32_t)argsSize;
+	}
+
+	if (offset % 4 != 0 || stride % 4 != 0 || stride < argsSize)
+	{
+		spel_error(SPEL_ERR_INVALID_ARGUMENT,
+				   "indirect draw offset %zu and stride %u must be 4 byte aligned, and the "
+				   "stride at least %zu",
+				   offset, stride, argsSize);
+		return;
+	}
+
+	size_t end = offset + ((size_t)(drawCount - 1) * stride) + argsSize;
+	if (end > buf->size)
+	{
+		spel_error(SPEL_ERR_INVALID_ARGUMENT,
+				   "indirect draw reads up to byte %zu of a %zu byte buffer", end,
+				   buf->size);
+		return;
+	}
+
+	uint64_t start_offset = cl->offset;
+	spel_gfx_draw_indirect_cmd* cmd = (spel_gfx_draw_indirect_cmd*)cl->ctx->vt->cmdlist_alloc(
+		cl, sizeof(*cmd), _Alignof(spel_gfx_draw_indirect_cmd));
+
+	cmd->hdr.type = type;
+	cmd->hdr.size = cl->offset - start_offset;
+	cmd->sort_key = spel_gfx_cmdlist_sort_key(cl);
+	cmd->buf = buf;
+	cmd->offset = offset;
+	cmd->draw_count = drawCount;
+	cmd->stride = stride;
+}
+
+spel_api void spel_gfx_cmd_draw_indirect(spel_gfx_cmdlist cl, spel_gfx_buffer buf,
+										 size_t offset)
+{
+	spel_gfx_cmd_draw_indirect_record(cl, SPEL_GFX_CMD_DRAW_INDIRECT, buf, offset, 1, 0,
+									  sizeof(spel_gfx_draw_indirect_args));
+}
+
+spel_api void spel_gfx_cmd_draw_indirect_multi(spel_gfx_cmdlist cl, spel_gfx_buffer buf,
+											   size_t offset, uint32_t drawCount,
+											   uint32_t stride)
+{
+	spel_gfx_cmd_draw_indirect_record(cl, SPEL_GFX_CMD_DRAW_INDIRECT, buf, offset,
+									  drawCount, stride,
+									  sizeof(spel_gfx_draw_indirect_args));
+}
+
+spel_api void spel_gfx_cmd_draw_indexed_indirect(spel_gfx_cmdlist cl, spel_gfx_buffer buf,
+												 size_t offset)
+{
+	spel_gfx_cmd_draw_indirect_record(cl, SPEL_GFX_CMD_DRAW_INDEXED_INDIRECT, buf, offset,
+									  1, 0, sizeof(spel_gfx_draw_indexed_indirect_args));
+}
+
+spel_api void spel_gfx_cmd_draw_indexed_indirect_multi(spel_gfx_cmdlist cl,
+													   spel_gfx_buffer buf, size_t offset,
+													   uint32_t drawCount, uint32_t stride)
+{
+	spel_gfx_cmd_draw_indirect_record(cl, SPEL_GFX_CMD_DRAW_INDEXED_INDIRECT, buf, offset,
+									  drawCount, stride,
+									  sizeof(spel_gfx_draw_indexed_indirect_args));
+}
+
+// the recorder only knows the pipeline while nothing else (an execute) got in the way
+static bool spel_gfx_cmd_check_compute(spel_gfx_cmdlist cl)
+{
+	if (cl->state.pipeline && cl->state.pipeline->type != SPEL_GFX_PIPELINE_COMPUTE)
+	{
+		spel_error(SPEL_ERR_INVALID_STATE,
+				   "dispatching needs a compute pipeline bound, not a graphics one");
+		return false;
+	}
+
+	return true;
+}
+
+spel_api void spel_gfx_cmd_dispatch(spel_gfx_cmdlist cl, uint32_t groupsX, uint32_t groupsY,
+									uint32_t groupsZ)
+{
+	if (groupsX == 0 || groupsY == 0 || groupsZ == 0 || !spel_gfx_cmd_check_compute(cl))
+	{
+		return;
+	}
+
+	uint64_t start_offset = cl->offset;
+	spel_gfx_dispatch_cmd* cmd = (spel_gfx_dispatch_cmd*)cl->ctx->vt->cmdlist_alloc(
+		cl, sizeof(*cmd), _Alignof(spel_gfx_dispatch_cmd));
+
+	cmd->hdr.type = SPEL_GFX_CMD_DISPATCH;
+	cmd->hdr.size = cl->offset - start_offset;
+	cmd->groups_x = groupsX;
+	cmd->groups_y = groupsY;
+	cmd->groups_z = groupsZ;
+}
+
+spel_api void spel_gfx_cmd_dispatch_indirect(spel_gfx_cmdlist cl, spel_gfx_buffer buf,
+											 size_t offset)
+{
+	if (buf == NULL)
+	{
+		spel_error(SPEL_ERR_INVALID_ARGUMENT, "indirect dispatches need an argument buffer");
+		return;
+	}
+
+	if (!spel_gfx_cmd_check_compute(cl))
+	{
+		return;
+	}
+
+	if (buf->type != SPEL_GFX_BUFFER_INDIRECT)
+	{
+		spel_warn("buffer type does not correspond to binding cmd (indirect). this is "
+				  "allowed, but discouraged");
+	}
+
+	if (offset % 4 != 0 || offset + sizeof(spel_gfx_dispatch_indirect_args) > buf->size)
+	{
+		spel_error(SPEL_ERR_INVALID_ARGUMENT,
+				   "indirect dispatch offset %zu is unaligned or past the end of a %zu "
+				   "byte buffer",
+				   offset, buf->size);
+		return;
+	}
+
+	uint64_t start_offset = cl->offset;
+	spel_gfx_dispatch_indirect_cmd* cmd =
+		(spel_gfx_dispatch_indirect_cmd*)cl->ctx->vt->cmdlist_alloc(
+			cl, sizeof(*cmd), _Alignof(spel_gfx_dispatch_indirect_cmd));
+
+	cmd->hdr.type = SPEL_GFX_CMD_DISPATCH_INDIRECT;
+	cmd->hdr.size = cl->offset - start_offset;
+	cmd->buf = buf;
+	cmd->offset = offset;
+}
+
+spel_api void spel_gfx_cmd_barrier(spel_gfx_cmdlist cl, spel_gfx_barrier barriers)
+{
+	if (barriers == 0)
+	{
+		return;
+	}
+
+	uint64_t start_offset = cl->offset;
+	spel_gfx_barrier_cmd* cmd = (spel_gfx_barrier_cmd*)cl->ctx->vt->cmdlist_alloc(
+		cl, sizeof(*cmd), _Alignof(spel_gfx_barrier_cmd));
+
+	cmd->hdr.type = SPEL_GFX_CMD_BARRIER;
+	cmd->hdr.size = cl->offset - start_offset;
+	cmd->barriers = barriers;
 }
 
 spel_api spel_gfx_cmdlist spel_gfx_cmdlist_default(spel_gfx_context ctx)
@@ -387,6 +1266,31 @@ spel_api spel_gfx_pipeline spel_gfx_pipeline_create(spel_gfx_context ctx,
 	return ctx->vt->pipeline_create(ctx, desc);
 }
 
+spel_api void spel_gfx_pipeline_precompile(spel_gfx_context ctx,
+										  const spel_gfx_pipeline_desc* descs,
+										  uint32_t count, spel_gfx_pipeline* out)
+{
+	if (descs == NULL && count > 0)
+	{
+		spel_error(SPEL_ERR_INVALID_ARGUMENT, "precompile needs %u pipeline descs", count);
+		return;
+	}
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		spel_gfx_pipeline pipeline = ctx->vt->pipeline_precompile(ctx, &descs[i]);
+		if (out != NULL)
+		{
+			out[i] = pipeline;
+		}
+	}
+}
+
+spel_api bool spel_gfx_pipeline_ready(spel_gfx_pipeline pipeline)
+{
+	return pipeline->ctx->vt->pipeline_ready(pipeline);
+}
+
 spel_hidden void spel_gfx_pipeline_cache_remove(spel_gfx_pipeline_cache* cache,
 												uint64_t hash, spel_gfx_pipeline pipeline)
 {
@@ -440,43 +1344,8 @@ spel_api void spel_gfx_pipeline_destroy(spel_gfx_pipeline pipeline)
 {
 	spel_gfx_pipeline_cache_remove(&pipeline->ctx->pipeline_cache, pipeline->hash,
 								   pipeline);
-
-	for (uint32_t i = 0; i < pipeline->reflection.uniform_count; ++i)
-	{
-		spel_gfx_shader_block* block = &pipeline->reflection.uniforms[i];
-		if (block->members)
-		{
-			for (uint32_t m = 0; m < block->member_count; ++m)
-			{
-				spel_memory_free(block->members[m].name);
-			}
-			spel_memory_free(block->members);
-		}
-		spel_memory_free(block->name);
-	}
-
-	for (uint32_t i = 0; i < pipeline->reflection.storage_count; ++i)
-	{
-		spel_gfx_shader_block* block = &pipeline->reflection.storage[i];
-		if (block->members)
-		{
-			for (uint32_t m = 0; m < block->member_count; ++m)
-			{
-				spel_memory_free(block->members[m].name);
-			}
-			spel_memory_free(block->members);
-		}
-		spel_memory_free(block->name);
-	}
-
-	for (uint32_t i = 0; i < pipeline->reflection.sampler_count; ++i)
-	{
-		spel_memory_free(pipeline->reflection.samplers[i].name);
-	}
-
-	spel_memory_free(pipeline->reflection.samplers);
-	spel_memory_free(pipeline->reflection.storage);
-	spel_memory_free(pipeline->reflection.uniforms);
+	spel_gfx_pipeline_reflection_free(pipeline);
+	spel_gfx_resource_retired(pipeline->ctx);
 	pipeline->ctx->vt->pipeline_destroy(pipeline);
 }
 
@@ -716,6 +1585,22 @@ spel_api spel_gfx_sampler spel_gfx_sampler_get(spel_gfx_context ctx,
 spel_api void spel_gfx_cmd_bind_texture(spel_gfx_cmdlist cl, uint32_t slot,
 										spel_gfx_texture texture)
 {
+	if (texture == NULL)
+	{
+		spel_error(SPEL_ERR_INVALID_ARGUMENT, "cannot bind a null texture to slot %u", slot);
+		return;
+	}
+
+	spel_gfx_cmdlist_state_sync(cl);
+	if (slot < SPEL_GFX_CMDLIST_TRACKED_SLOTS)
+	{
+		if (cl->state.textures[slot] == texture)
+		{
+			return;
+		}
+		cl->state.textures[slot] = texture;
+	}
+
 	uint64_t start_offset = cl->offset;
 	spel_gfx_bind_texture_cmd* cmd =
 		(spel_gfx_bind_texture_cmd*)cl->ctx->vt->cmdlist_alloc(
@@ -730,6 +1615,22 @@ spel_api void spel_gfx_cmd_bind_texture(spel_gfx_cmdlist cl, uint32_t slot,
 spel_api void spel_gfx_cmd_bind_sampler(spel_gfx_cmdlist cl, uint32_t slot,
 										spel_gfx_sampler sampler)
 {
+	if (sampler == NULL)
+	{
+		spel_error(SPEL_ERR_INVALID_ARGUMENT, "cannot bind a null sampler to slot %u", slot);
+		return;
+	}
+
+	spel_gfx_cmdlist_state_sync(cl);
+	if (slot < SPEL_GFX_CMDLIST_TRACKED_SLOTS)
+	{
+		if (cl->state.samplers[slot] == sampler)
+		{
+			return;
+		}
+		cl->state.samplers[slot] = sampler;
+	}
+
 	uint64_t start_offset = cl->offset;
 	spel_gfx_bind_sampler_cmd* cmd =
 		(spel_gfx_bind_sampler_cmd*)cl->ctx->vt->cmdlist_alloc(
@@ -744,6 +1645,24 @@ spel_api void spel_gfx_cmd_bind_sampler(spel_gfx_cmdlist cl, uint32_t slot,
 spel_api void spel_gfx_cmd_bind_image(spel_gfx_cmdlist cl, uint32_t slot,
 									  spel_gfx_texture texture, spel_gfx_sampler sampler)
 {
+	if (texture == NULL || sampler == NULL)
+	{
+		spel_error(SPEL_ERR_INVALID_ARGUMENT,
+				   "cannot bind an image to slot %u without a texture and a sampler", slot);
+		return;
+	}
+
+	spel_gfx_cmdlist_state_sync(cl);
+	if (slot < SPEL_GFX_CMDLIST_TRACKED_SLOTS)
+	{
+		if (cl->state.textures[slot] == texture && cl->state.samplers[slot] == sampler)
+		{
+			return;
+		}
+		cl->state.textures[slot] = texture;
+		cl->state.samplers[slot] = sampler;
+	}
+
 	uint64_t start_offset = cl->offset;
 	spel_gfx_bind_image_cmd* cmd = (spel_gfx_bind_image_cmd*)cl->ctx->vt->cmdlist_alloc(
 		cl, sizeof(*cmd), _Alignof(spel_gfx_bind_image_cmd));
@@ -758,6 +1677,12 @@ spel_api void spel_gfx_cmd_bind_image(spel_gfx_cmdlist cl, uint32_t slot,
 spel_api void spel_gfx_cmd_buffer_update(spel_gfx_cmdlist cl, spel_gfx_buffer buf,
 										 const void* data, size_t size, size_t offset)
 {
+	if (buf == NULL)
+	{
+		spel_error(SPEL_ERR_INVALID_ARGUMENT, "cannot update a null buffer");
+		return;
+	}
+
 	if (offset + size > buf->size)
 	{
 		spel_error(
@@ -854,6 +1779,11 @@ spel_api spel_gfx_texture spel_gfx_texture_create(spel_gfx_context ctx,
 
 spel_api void spel_gfx_texture_destroy(spel_gfx_texture texture)
 {
+	if (texture->loading)
+	{
+		spel_gfx_texture_loader_cancel(texture);
+	}
+	spel_gfx_resource_retired(texture->ctx);
 	texture->ctx->vt->texture_destroy(texture);
 }
 
@@ -883,9 +1813,15 @@ spel_api spel_gfx_sampler_desc spel_gfx_sampler_default()
 	return DEFAULT_SAMPLER;
 }
 
+// staging lives in the frame arena when possible, callers rewind once uploaded
 uint8_t* rgb_to_rgba(const uint8_t* src, int pixelCount)
 {
-	uint8_t* dst = spel_memory_malloc((unsigned long)(pixelCount * 4), SPEL_MEM_TAG_GFX);
+	uint8_t* dst = spel_memory_frame_alloc((size_t)pixelCount * 4);
+	if (!dst)
+	{
+		dst = spel_memory_malloc((size_t)pixelCount * 4, SPEL_MEM_TAG_GFX);
+	}
+
 	if (!dst)
 	{
 		return NULL;
@@ -902,33 +1838,29 @@ uint8_t* rgb_to_rgba(const uint8_t* src, int pixelCount)
 	return dst;
 }
 
-spel_api spel_gfx_texture spel_gfx_texture_load(spel_gfx_context ctx, const char* path,
-												const spel_gfx_texture_load_desc* desc)
+// fills `tex` for pixels straight out of stb_image. returns what to upload, which
+// is `pixels` or an rgba copy when the format comes from the channel count, NULL
+// when the image can't be used. `pixels` is left to the caller either way
+spel_hidden uint8_t*
+spel_gfx_texture_decoded_desc(uint8_t* pixels, int w, int h, int comp,
+							  const spel_gfx_texture_load_desc* desc,
+							  spel_gfx_texture_desc* tex)
 {
-	int w;
-	int h;
-	int comp;
-	stbi_uc* pixels = stbi_load(path, &w, &h, &comp, 0);
-	if (!pixels)
-	{
-		return spel_gfx_texture_checker_get(ctx);
-	}
-
 	uint8_t* upload_pixels = pixels;
 	size_t upload_size = 0;
 
-	spel_gfx_texture_desc tex = {0};
-	tex.type = SPEL_GFX_TEXTURE_2D;
-	tex.width = w;
-	tex.height = h;
-	tex.depth = 1;
-	tex.mip_count =
+	memset(tex, 0, sizeof(*tex));
+	tex->type = SPEL_GFX_TEXTURE_2D;
+	tex->width = w;
+	tex->height = h;
+	tex->depth = 1;
+	tex->mip_count =
 		desc->mip_count ? desc->mip_count : (1 + (uint32_t)floor(log2(fmax(w, h))));
-	tex.usage = desc->usage;
+	tex->usage = desc->usage;
 
 	if (desc->format != SPEL_GFX_TEXTURE_FMT_UNKNOWN)
 	{
-		tex.format = desc->format;
+		tex->format = desc->format;
 		upload_size = (size_t)w * h * comp;
 	}
 	else
@@ -936,60 +1868,84 @@ spel_api spel_gfx_texture spel_gfx_texture_load(spel_gfx_context ctx, const char
 		if ((int)desc->srgb && comp < 3)
 		{
 			spel_error(SPEL_ERR_INVALID_ARGUMENT, "sRGB requested for non-RGB texture");
-			stbi_image_free(pixels);
-			return spel_gfx_texture_checker_get(ctx);
+			return NULL;
 		}
 
 		switch (comp)
 		{
 		case 1:
-			tex.format = SPEL_GFX_TEXTURE_FMT_R8_UNORM;
+			tex->format = SPEL_GFX_TEXTURE_FMT_R8_UNORM;
 			upload_size = (size_t)w * h;
 			break;
 
 		case 2:
-			tex.format = SPEL_GFX_TEXTURE_FMT_RG8_UNORM;
+			tex->format = SPEL_GFX_TEXTURE_FMT_RG8_UNORM;
 			upload_size = (size_t)w * h * 2;
 			break;
 
 		case 3:
 			upload_pixels = rgb_to_rgba(pixels, w * h);
 			upload_size = (size_t)w * h * 4;
-			stbi_image_free(pixels);
-			pixels = NULL;
 
-			tex.format = (int)desc->srgb ? SPEL_GFX_TEXTURE_FMT_RGBA8_SRGB
-										 : SPEL_GFX_TEXTURE_FMT_RGBA8_UNORM;
+			tex->format = (int)desc->srgb ? SPEL_GFX_TEXTURE_FMT_RGBA8_SRGB
+										  : SPEL_GFX_TEXTURE_FMT_RGBA8_UNORM;
 			break;
 
 		case 4:
-			tex.format = (int)desc->srgb ? SPEL_GFX_TEXTURE_FMT_RGBA8_SRGB
-										 : SPEL_GFX_TEXTURE_FMT_RGBA8_UNORM;
+			tex->format = (int)desc->srgb ? SPEL_GFX_TEXTURE_FMT_RGBA8_SRGB
+										  : SPEL_GFX_TEXTURE_FMT_RGBA8_UNORM;
 			upload_size = (size_t)w * h * 4;
 			break;
 
 		default:
-			stbi_image_free(pixels);
-			return spel_gfx_texture_checker_get(ctx);
+			return NULL;
 		}
 	}
 
-	tex.data = upload_pixels;
-	tex.data_size = upload_size;
+	tex->data = upload_pixels;
+	tex->data_size = upload_size;
+	return upload_pixels;
+}
+
+static spel_gfx_texture
+spel_gfx_texture_from_pixels(spel_gfx_context ctx, stbi_uc* pixels, int w, int h,
+							 int comp, const spel_gfx_texture_load_desc* desc)
+{
+	spel_memory_frame_marker marker = spel_memory_frame_mark();
+
+	spel_gfx_texture_desc tex;
+	uint8_t* upload_pixels = spel_gfx_texture_decoded_desc(pixels, w, h, comp, desc, &tex);
+	if (!upload_pixels)
+	{
+		stbi_image_free(pixels);
+		return spel_gfx_texture_checker_get(ctx);
+	}
 
 	spel_gfx_texture out = spel_gfx_texture_create(ctx, &tex);
 
-	if (upload_pixels && upload_pixels != pixels)
+	if (upload_pixels != pixels && !spel_memory_frame_owns(upload_pixels))
 	{
 		spel_memory_free(upload_pixels);
 	}
+	spel_memory_frame_rewind(marker);
 
-	if (pixels)
+	stbi_image_free(pixels);
+	return out;
+}
+
+spel_api spel_gfx_texture spel_gfx_texture_load(spel_gfx_context ctx, const char* path,
+												const spel_gfx_texture_load_desc* desc)
+{
+	int w;
+	int h;
+	int comp;
+	stbi_uc* pixels = stbi_load(path, &w, &h, &comp, 0);
+	if (!pixels)
 	{
-		stbi_image_free(pixels);
+		return spel_gfx_texture_checker_get(ctx);
 	}
 
-	return out;
+	return spel_gfx_texture_from_pixels(ctx, pixels, w, h, comp, desc);
 }
 
 spel_api spel_gfx_texture
@@ -1006,82 +1962,7 @@ spel_gfx_texture_load_data(spel_gfx_context ctx, const char* data, size_t dataSi
 		return spel_gfx_texture_checker_get(ctx);
 	}
 
-	uint8_t* upload_pixels = pixels;
-	size_t upload_size = 0;
-
-	spel_gfx_texture_desc tex = {0};
-	tex.type = SPEL_GFX_TEXTURE_2D;
-	tex.width = w;
-	tex.height = h;
-	tex.depth = 1;
-	tex.mip_count =
-		desc->mip_count ? desc->mip_count : (1 + (uint32_t)floor(log2(fmax(w, h))));
-	tex.usage = desc->usage;
-
-	if (desc->format != SPEL_GFX_TEXTURE_FMT_UNKNOWN)
-	{
-		tex.format = desc->format;
-		upload_size = (size_t)w * h * comp;
-	}
-	else
-	{
-		if ((int)desc->srgb && comp < 3)
-		{
-			spel_error(SPEL_ERR_INVALID_ARGUMENT, "sRGB requested for non-RGB texture");
-			stbi_image_free(pixels);
-			return spel_gfx_texture_checker_get(ctx);
-		}
-
-		switch (comp)
-		{
-		case 1:
-			tex.format = SPEL_GFX_TEXTURE_FMT_R8_UNORM;
-			upload_size = (size_t)w * h;
-			break;
-
-		case 2:
-			tex.format = SPEL_GFX_TEXTURE_FMT_RG8_UNORM;
-			upload_size = (size_t)w * h * 2;
-			break;
-
-		case 3:
-			upload_pixels = rgb_to_rgba(pixels, w * h);
-			upload_size = (size_t)w * h * 4;
-			stbi_image_free(pixels);
-			pixels = NULL;
-
-			tex.format = (int)desc->srgb ? SPEL_GFX_TEXTURE_FMT_RGBA8_SRGB
-										 : SPEL_GFX_TEXTURE_FMT_RGBA8_UNORM;
-			break;
-
-		case 4:
-			tex.format = (int)desc->srgb ? SPEL_GFX_TEXTURE_FMT_RGBA8_SRGB
-										 : SPEL_GFX_TEXTURE_FMT_RGBA8_UNORM;
-			upload_size = (size_t)w * h * 4;
-			break;
-
-		default:
-			stbi_image_free(pixels);
-			return spel_gfx_texture_checker_get(ctx);
-		}
-	}
-
-	tex.data = upload_pixels;
-	tex.data_size = upload_size;
-
-	spel_gfx_texture out = spel_gfx_texture_create(ctx, &tex);
-
-	if (upload_pixels && upload_pixels != pixels)
-	{
-		spel_memory_free(upload_pixels);
-	}
-
-	if (pixels)
-	{
-		stbi_image_free(pixels);
-	}
-
-	return out;
+	return spel_gfx_texture_from_pixels(ctx, pixels, w, h, comp, desc);
 }
 
 spel_api spel_gfx_texture spel_gfx_texture_load_color(spel_gfx_context ctx,
@@ -1193,7 +2074,7 @@ spel_api spel_gfx_uniform* spel_gfx_uniform_list(spel_gfx_pipeline pipeline,
 	}
 
 	spel_gfx_uniform* uniforms =
-		spel_memory_malloc(member_count * sizeof(*uniforms), SPEL_MEM_TAG_GFX);
+		spel_memory_calloc(member_count, sizeof(*uniforms), SPEL_MEM_TAG_GFX);
 
 	// second pass: filling it up
 	uint32_t idx = 0;
@@ -1236,35 +2117,20 @@ spel_api spel_gfx_uniform* spel_gfx_uniform_list(spel_gfx_pipeline pipeline,
 const spel_api char* spel_gfx_uniform_name(spel_gfx_pipeline pipeline,
 										   spel_gfx_uniform handle)
 {
-	for (size_t i = 0; i < pipeline->reflection.uniform_count; i++)
+	spel_gfx_shader_block* block = spel_gfx_reflection_block(
+		pipeline, spel_gfx_reflection_find(&pipeline->lookup.locations, handle.location));
+
+	if (block == NULL)
 	{
-		spel_gfx_shader_block* block = &pipeline->reflection.uniforms[i];
-		if (block->location == handle.location)
-		{
-			for (uint32_t j = 0; j < block->member_count; j++)
-			{
-				spel_gfx_shader_uniform* member = &block->members[j];
-				if (member->offset == handle.offset)
-				{
-					return member->name;
-				}
-			}
-		}
+		return "";
 	}
 
-	for (size_t i = 0; i < pipeline->reflection.storage_count; i++)
+	for (uint32_t j = 0; j < block->member_count; j++)
 	{
-		spel_gfx_shader_block* block = &pipeline->reflection.storage[i];
-		if (block->location == handle.location)
+		spel_gfx_shader_uniform* member = &block->members[j];
+		if (member->offset == handle.offset)
 		{
-			for (uint32_t j = 0; j < block->member_count; j++)
-			{
-				spel_gfx_shader_uniform* member = &block->members[j];
-				if (member->offset == handle.offset)
-				{
-					return member->name;
-				}
-			}
+			return member->name;
 		}
 	}
 
@@ -1274,25 +2140,10 @@ const spel_api char* spel_gfx_uniform_name(spel_gfx_pipeline pipeline,
 spel_api uint32_t spel_gfx_uniform_block_size(spel_gfx_pipeline pipeline,
 											  spel_gfx_uniform handle)
 {
-	for (size_t i = 0; i < pipeline->reflection.uniform_count; i++)
-	{
-		spel_gfx_shader_block* block = &pipeline->reflection.uniforms[i];
-		if (block->location == handle.location)
-		{
-			return block->size;
-		}
-	}
+	spel_gfx_shader_block* block = spel_gfx_reflection_block(
+		pipeline, spel_gfx_reflection_find(&pipeline->lookup.locations, handle.location));
 
-	for (size_t i = 0; i < pipeline->reflection.storage_count; i++)
-	{
-		spel_gfx_shader_block* block = &pipeline->reflection.storage[i];
-		if (block->location == handle.location)
-		{
-			return block->size;
-		}
-	}
-
-	return 0;
+	return block ? block->size : 0;
 }
 
 spel_api spel_gfx_uniform spel_gfx_uniform_get(spel_gfx_pipeline pipeline,
@@ -1300,39 +2151,24 @@ spel_api spel_gfx_uniform spel_gfx_uniform_get(spel_gfx_pipeline pipeline,
 {
 	spel_gfx_uniform uniform;
 
-	for (size_t i = 0; i < pipeline->reflection.uniform_count; i++)
-	{
-		spel_gfx_shader_block* block = &pipeline->reflection.uniforms[i];
-		for (uint32_t j = 0; j < block->member_count; j++)
-		{
-			spel_gfx_shader_uniform* member = &block->members[j];
-			if (strcmp(name, member->name) == 0)
-			{
-				uniform.set = member->set;
-				uniform.binding = member->binding;
-				uniform.count = member->array_count;
-				uniform.offset = member->offset;
-				uniform.size = member->size;
-				return uniform;
-			}
-		}
-	}
+	uint64_t key = spel_gfx_reflect_name_hash(name);
+	const spel_gfx_reflection_slot* slot =
+		spel_gfx_reflection_find(&pipeline->lookup.members, key);
 
-	for (size_t i = 0; i < pipeline->reflection.storage_count; i++)
+	// a hash hit still gets its name checked, collisions are unlikely but not impossible
+	if (slot != NULL)
 	{
-		spel_gfx_shader_block* block = &pipeline->reflection.storage[i];
-		for (uint32_t j = 0; j < block->member_count; j++)
+		spel_gfx_shader_uniform* member =
+			&spel_gfx_reflection_block(pipeline, slot)->members[slot->member];
+
+		if (strcmp(name, member->name) == 0)
 		{
-			spel_gfx_shader_uniform* member = &block->members[j];
-			if (strcmp(name, member->name) == 0)
-			{
-				uniform.set = member->set;
-				uniform.binding = member->binding;
-				uniform.count = member->array_count;
-				uniform.offset = member->offset;
-				uniform.size = member->size;
-				return uniform;
-			}
+			uniform.set = member->set;
+			uniform.binding = member->binding;
+			uniform.count = member->array_count;
+			uniform.offset = member->offset;
+			uniform.size = member->size;
+			return uniform;
 		}
 	}
 
@@ -1351,13 +2187,40 @@ spel_api void spel_gfx_buffer_flush(spel_gfx_buffer buf, size_t offset, size_t s
 	buf->ctx->vt->buffer_flush(buf, offset, size);
 }
 
-spel_api void spel_gfx_cmd_bind_shader_buffer(spel_gfx_cmdlist cl,
-											  spel_gfx_uniform_buffer buf)
+// size 0 binds the whole buffer
+static void spel_gfx_cmd_bind_shader_buffer_range(spel_gfx_cmdlist cl, uint32_t location,
+												  spel_gfx_buffer buf, size_t offset,
+												  size_t size)
 {
-	if (buf.buffer == NULL)
+	spel_gfx_cmdlist_state_sync(cl);
+	spel_gfx_cmdlist_state* state = &cl->state;
+	uint32_t tracked = state->shader_buffer_count;
+	for (uint32_t i = 0; i < state->shader_buffer_count; i++)
 	{
-		spel_error(SPEL_ERR_INVALID_ARGUMENT, "cannot bind an invalid shader buffer");
-		return;
+		if (state->shader_buffers[i].location == location)
+		{
+			if (state->shader_buffers[i].buf == buf &&
+				state->shader_buffers[i].offset == offset &&
+				state->shader_buffers[i].size == size)
+			{
+				return;
+			}
+			tracked = i;
+			break;
+		}
+	}
+
+	// past the table size the bind just always gets recorded
+	if (tracked < SPEL_GFX_CMDLIST_TRACKED_BUFFERS)
+	{
+		state->shader_buffers[tracked].location = location;
+		state->shader_buffers[tracked].buf = buf;
+		state->shader_buffers[tracked].offset = offset;
+		state->shader_buffers[tracked].size = size;
+		if (tracked == state->shader_buffer_count)
+		{
+			state->shader_buffer_count++;
+		}
 	}
 
 	uint64_t start_offset = cl->offset;
@@ -1367,8 +2230,22 @@ spel_api void spel_gfx_cmd_bind_shader_buffer(spel_gfx_cmdlist cl,
 
 	cmd->hdr.type = SPEL_GFX_CMD_BIND_SHADER_BUFFER;
 	cmd->hdr.size = cl->offset - start_offset;
-	cmd->buf = buf.buffer;
-	cmd->location = buf.location;
+	cmd->buf = buf;
+	cmd->location = location;
+	cmd->offset = offset;
+	cmd->size = size;
+}
+
+spel_api void spel_gfx_cmd_bind_shader_buffer(spel_gfx_cmdlist cl,
+											  spel_gfx_uniform_buffer buf)
+{
+	if (buf.buffer == NULL)
+	{
+		spel_error(SPEL_ERR_INVALID_ARGUMENT, "cannot bind an invalid shader buffer");
+		return;
+	}
+
+	spel_gfx_cmd_bind_shader_buffer_range(cl, buf.location, buf.buffer, 0, 0);
 }
 
 spel_api char** spel_gfx_uniform_block_names(spel_gfx_pipeline pipeline, uint32_t* count)
@@ -1398,40 +2275,21 @@ spel_api char** spel_gfx_uniform_block_names(spel_gfx_pipeline pipeline, uint32_
 	return arr;
 }
 
-spel_api spel_gfx_uniform_buffer
-spel_gfx_uniform_buffer_create(spel_gfx_pipeline pipeline, const char* blockName)
+spel_api spel_gfx_uniform_buffer spel_gfx_uniform_block_get(spel_gfx_pipeline pipeline,
+															const char* blockName)
 {
 	if (pipeline == NULL || blockName == NULL)
 	{
 		spel_error(SPEL_ERR_INVALID_ARGUMENT,
-				   "uniform buffer create requires valid pipeline and block name");
+				   "uniform block lookup requires valid pipeline and block name");
 		return (spel_gfx_uniform_buffer){0};
 	}
 
-	spel_gfx_shader_block* block = NULL;
-
-	for (size_t i = 0; i < pipeline->reflection.uniform_count; i++)
-	{
-		if (strcmp(pipeline->reflection.uniforms[i].name, blockName) == 0)
-		{
-			block = &pipeline->reflection.uniforms[i];
-			break;
-		}
-	}
-
-	if (block == NULL)
-	{
-		for (size_t i = 0; i < pipeline->reflection.storage_count; i++)
-		{
-			if (strcmp(pipeline->reflection.storage[i].name, blockName) == 0)
-			{
-				block = &pipeline->reflection.storage[i];
-				break;
-			}
-		}
-	}
+	spel_gfx_shader_block* block = spel_gfx_reflection_block(
+		pipeline, spel_gfx_reflection_find(&pipeline->lookup.blocks,
+										   spel_gfx_reflect_name_hash(blockName)));
 
-	if (block == NULL)
+	if (block == NULL || strcmp(block->name, blockName) != 0)
 	{
 		spel_error(SPEL_ERR_INVALID_ARGUMENT,
 				   "uniform block %s not found in pipeline %X", blockName,
@@ -1446,25 +2304,133 @@ spel_gfx_uniform_buffer_create(spel_gfx_pipeline pipeline, const char* blockName
 		return (spel_gfx_uniform_buffer){0};
 	}
 
+	return (spel_gfx_uniform_buffer){
+		.location = block->location, .buffer = NULL, .size = block->size};
+}
+
+spel_api spel_gfx_uniform_buffer
+spel_gfx_uniform_buffer_create(spel_gfx_pipeline pipeline, const char* blockName)
+{
+	spel_gfx_uniform_buffer block = spel_gfx_uniform_block_get(pipeline, blockName);
+	if (block.size == 0)
+	{
+		return block;
+	}
+
 	spel_gfx_buffer_desc buffer_desc;
 	buffer_desc.type = SPEL_GFX_BUFFER_UNIFORM;
 	buffer_desc.usage = SPEL_GFX_USAGE_DYNAMIC;
 	buffer_desc.access = SPEL_GFX_BUFFER_DRAW;
+	buffer_desc.persistent = false;
 	buffer_desc.data = NULL;
-	buffer_desc.size = block->size;
+	buffer_desc.size = block.size;
 
-	spel_gfx_buffer buffer = spel_gfx_buffer_create(pipeline->ctx, &buffer_desc);
-	if (buffer == NULL)
+	block.buffer = spel_gfx_buffer_create(pipeline->ctx, &buffer_desc);
+	if (block.buffer == NULL)
 	{
 		spel_error(SPEL_ERR_OOM, "failed to create uniform buffer for block %s",
 				   blockName);
 		return (spel_gfx_uniform_buffer){0};
 	}
 
-	return (spel_gfx_uniform_buffer){
-		.location = block->location,
-		.buffer = buffer,
-		.size = block->size};
+	return block;
+}
+
+spel_api spel_gfx_ring_slice spel_gfx_uniform_alloc(spel_gfx_context ctx, size_t size)
+{
+	if (size == 0)
+	{
+		spel_error(SPEL_ERR_INVALID_ARGUMENT, "cannot allocate an empty uniform slice");
+		return (spel_gfx_ring_slice){0};
+	}
+
+	if (ctx->uniform_ring == NULL)
+	{
+		ctx->uniform_ring = spel_gfx_ring_create(ctx, SPEL_GFX_BUFFER_UNIFORM,
+												 SPEL_GFX_UNIFORM_RING_SIZE);
+		if (ctx->uniform_ring == NULL)
+		{
+			return (spel_gfx_ring_slice){0};
+		}
+	}
+
+	return spel_gfx_ring_alloc(ctx->uniform_ring, size, ctx->uniform_align);
+}
+
+spel_api uint32_t spel_gfx_uniform_alignment(spel_gfx_context ctx)
+{
+	return ctx->uniform_align;
+}
+
+spel_api void spel_gfx_cmd_uniform_push(spel_gfx_cmdlist cl,
+										spel_gfx_uniform_buffer block, const void* data,
+										size_t size)
+{
+	if (block.size == 0)
+	{
+		spel_error(SPEL_ERR_INVALID_ARGUMENT, "cannot push to an invalid uniform block");
+		return;
+	}
+
+	if (data == NULL || size == 0 || size > block.size)
+	{
+		spel_error(SPEL_ERR_INVALID_ARGUMENT,
+				   "uniform push needs 1 to %u bytes of data, got %zu", block.size, size);
+		return;
+	}
+
+	// the slice is gone once the frame is, a bundle would replay stale data. the
+	// ring is shared by the whole context and may create gl buffers, so secondaries
+	// recorded on workers can't touch it either
+	if (cl->secondary)
+	{
+		spel_error(SPEL_ERR_INVALID_STATE,
+				   "uniform pushes only work on primary command lists");
+		return;
+	}
+
+	// gl leaves a range smaller than the block undefined, the tail gets zeroed
+	spel_gfx_ring_slice slice = spel_gfx_uniform_alloc(cl->ctx, block.size);
+	if (slice.data == NULL)
+	{
+		return;
+	}
+
+	memcpy(slice.data, data, size);
+	memset((uint8_t*)slice.data + size, 0, block.size - size);
+	spel_gfx_cmd_bind_shader_buffer_range(cl, block.location, slice.buffer, slice.offset,
+										  block.size);
+}
+
+spel_api void spel_gfx_cmd_bind_shader_buffer_offset(spel_gfx_cmdlist cl,
+													 spel_gfx_uniform_buffer block,
+													 spel_gfx_buffer buffer,
+													 size_t offset)
+{
+	if (block.size == 0 || buffer == NULL)
+	{
+		spel_error(SPEL_ERR_INVALID_ARGUMENT,
+				   "offset bind needs a valid uniform block and buffer");
+		return;
+	}
+
+	if (offset % cl->ctx->uniform_align != 0)
+	{
+		spel_error(SPEL_ERR_INVALID_ARGUMENT,
+				   "offset %zu isn't aligned to the %u byte uniform offset alignment",
+				   offset, cl->ctx->uniform_align);
+		return;
+	}
+
+	if (offset + block.size > buffer->size)
+	{
+		spel_error(SPEL_ERR_INVALID_ARGUMENT,
+				   "binding %u bytes at offset %zu runs past the %zu byte buffer",
+				   block.size, offset, buffer->size);
+		return;
+	}
+
+	spel_gfx_cmd_bind_shader_buffer_range(cl, block.location, buffer, offset, block.size);
 }
 
 spel_api void spel_gfx_cmd_uniform_update(spel_gfx_cmdlist cl,
@@ -1537,6 +2503,18 @@ spel_api void spel_gfx_framebuffer_destroy(spel_gfx_framebuffer fb)
 
 spel_api void spel_gfx_cmd_begin_pass(spel_gfx_cmdlist cl, spel_gfx_render_pass pass)
 {
+	if (cl->secondary && !cl->bundle)
+	{
+		spel_error(SPEL_ERR_INVALID_STATE,
+				   "secondary command lists run inside the primary's pass, they can't "
+				   "begin their own");
+		return;
+	}
+
+	cl->state.pass_index++;
+	cl->state.in_pass = true;
+	cl->state.opens_pass = true;
+
 	uint64_t start_offset = cl->offset;
 	spel_gfx_begin_render_pass_cmd* cmd =
 		(spel_gfx_begin_render_pass_cmd*)cl->ctx->vt->cmdlist_alloc(
@@ -1549,6 +2527,14 @@ spel_api void spel_gfx_cmd_begin_pass(spel_gfx_cmdlist cl, spel_gfx_render_pass
 
 spel_api void spel_gfx_cmd_end_pass(spel_gfx_cmdlist cl)
 {
+	if (cl->secondary && !cl->bundle)
+	{
+		spel_error(SPEL_ERR_INVALID_STATE, "secondary command lists can't end a pass");
+		return;
+	}
+
+	cl->state.in_pass = false;
+
 	uint64_t start_offset = cl->offset;
 	spel_gfx_end_render_pass_cmd* cmd =
 		(spel_gfx_end_render_pass_cmd*)cl->ctx->vt->cmdlist_alloc(
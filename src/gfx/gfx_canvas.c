@@ -11,6 +11,7 @@
 #include "gfx/gfx_types.h"
 #include "gfx_internal_shaders.h"
 #include <stdio.h>
+#include <string.h>
 
 #define SPEL_CANVAS_VBUFFER_SIZE 16384
 
@@ -22,7 +23,7 @@ spel_api spel_canvas spel_canvas_create(spel_gfx_context gfx, int width, int hei
 		spel_canvas_ctx_create(gfx);
 	}
 
-	spel_canvas canvas = spel_memory_malloc(sizeof(*canvas), SPEL_MEM_TAG_GFX);
+	spel_canvas canvas = spel_memory_calloc(1, sizeof(*canvas), SPEL_MEM_TAG_GFX);
 
 	canvas->ctx = gfx->canvas_ctx;
 	canvas->size.x = width;
@@ -155,13 +156,13 @@ void spel_canvas_clear(spel_color color)
 spel_hidden void spel_canvas_ctx_create(spel_gfx_context gfx)
 {
 	spel_canvas_context* ctx = gfx->canvas_ctx =
-		spel_memory_malloc(sizeof(*gfx->canvas_ctx), SPEL_MEM_TAG_GFX);
+		spel_memory_calloc(1, sizeof(*gfx->canvas_ctx), SPEL_MEM_TAG_GFX);
 
 	ctx->ctx = gfx;
 	ctx->command_list = spel_gfx_cmdlist_create(gfx);
 
 	ctx->default_canvas =
-		spel_memory_malloc(sizeof(*ctx->default_canvas), SPEL_MEM_TAG_GFX);
+		spel_memory_calloc(1, sizeof(*ctx->default_canvas), SPEL_MEM_TAG_GFX);
 
 	ctx->default_canvas->color = NULL;
 	ctx->default_canvas->depth = NULL;
@@ -172,28 +173,17 @@ spel_hidden void spel_canvas_ctx_create(spel_gfx_context gfx)
 	ctx->default_canvas->flags = SPEL_CANVAS_AUTO_RESIZE;
 	ctx->default_canvas->ctx = ctx;
 
-	spel_gfx_buffer_desc vbuffer_desc;
-	vbuffer_desc.type = SPEL_GFX_BUFFER_VERTEX;
-	vbuffer_desc.usage = SPEL_GFX_USAGE_DYNAMIC;
-	vbuffer_desc.access = SPEL_GFX_BUFFER_DRAW;
-	vbuffer_desc.data = NULL;
-	vbuffer_desc.size = SPEL_CANVAS_VBUFFER_SIZE;
-
-	spel_gfx_buffer_desc ibuffer_desc;
-	ibuffer_desc.type = SPEL_GFX_BUFFER_INDEX;
-	ibuffer_desc.usage = SPEL_GFX_USAGE_DYNAMIC;
-	ibuffer_desc.access = SPEL_GFX_BUFFER_DRAW;
-	ibuffer_desc.data = NULL;
-	ibuffer_desc.size = SPEL_CANVAS_VBUFFER_SIZE * 3 / 2;
-
 	ctx->transforms[0] = spel_mat3_identity();
 	ctx->transform_top = 0;
 
 	ctx->vert_cap = SPEL_CANVAS_VBUFFER_SIZE;
 	ctx->index_cap = SPEL_CANVAS_VBUFFER_SIZE * 3 / 2;
 
-	ctx->vbo = spel_gfx_buffer_create(gfx, &vbuffer_desc);
-	ctx->ibo = spel_gfx_buffer_create(gfx, &ibuffer_desc);
+	// every flush takes a fresh slice, leave room for a few batches before growing
+	ctx->vring = spel_gfx_ring_create(gfx, SPEL_GFX_BUFFER_VERTEX,
+									  (size_t)SPEL_CANVAS_VBUFFER_SIZE * 4);
+	ctx->iring = spel_gfx_ring_create(gfx, SPEL_GFX_BUFFER_INDEX,
+									  (size_t)SPEL_CANVAS_VBUFFER_SIZE * 6);
 
 	ctx->verts = spel_memory_malloc(SPEL_CANVAS_VBUFFER_SIZE, SPEL_MEM_TAG_GFX);
 	ctx->indices = spel_memory_malloc(SPEL_CANVAS_VBUFFER_SIZE * 3 / 2, SPEL_MEM_TAG_GFX);
@@ -211,7 +201,7 @@ spel_hidden void spel_canvas_ctx_create(spel_gfx_context gfx)
 	ctx->pipeline = ctx->og_pipeline;
 	ctx->white_texture = spel_gfx_texture_white_get(gfx);
 
-	ctx->ubuffer_frame = spel_gfx_uniform_buffer_create(ctx->pipeline, "FrameData");
+	ctx->ubuffer_frame = spel_gfx_uniform_block_get(ctx->pipeline, "FrameData");
 	ctx->pipeline_dirty = false;
 
 	ctx->sampler_desc = spel_gfx_sampler_default();
@@ -247,6 +237,8 @@ spel_hidden void spel_canvas_ctx_create(spel_gfx_context gfx)
 
 	spel_gfx_shader_desc canvas_frg_desc;
 	canvas_frg_desc.shader_source = SPEL_GFX_SHADER_STATIC;
+	canvas_frg_desc.constants = NULL;
+	canvas_frg_desc.constant_count = 0;
 	canvas_frg_desc.source = spel_internal_canvas_frag_spv;
 	canvas_frg_desc.source_size = spel_internal_canvas_frag_spv_len;
 	canvas_frg_desc.debug_name = "spel_internal_canvas_frag";
@@ -265,7 +257,7 @@ spel_hidden void spel_canvas_ctx_create(spel_gfx_context gfx)
 	ctx->font = ctx->geist;
 	ctx->default_shader = true;
 
-	ctx->font_ubuffer.buffer = NULL;
+	ctx->font_ubuffer.size = 0;
 
 	ctx->geist->internal = true;
 	ctx->vga->internal = true;
@@ -273,11 +265,6 @@ spel_hidden void spel_canvas_ctx_create(spel_gfx_context gfx)
 
 spel_hidden void spel_canvas_ctx_destroy(spel_canvas_context* ctx)
 {
-	if (ctx->font_ubuffer.buffer != NULL)
-	{
-		spel_gfx_uniform_buffer_destroy(ctx->font_ubuffer);
-	}
-
 	if (ctx->geist != NULL)
 	{
 		ctx->geist->internal = false;
@@ -312,9 +299,8 @@ spel_hidden void spel_canvas_ctx_destroy(spel_canvas_context* ctx)
 	spel_memory_free(ctx->verts);
 	spel_memory_free(ctx->indices);
 
-	spel_gfx_uniform_buffer_destroy(ctx->ubuffer_frame);
-	spel_gfx_buffer_destroy(ctx->vbo);
-	spel_gfx_buffer_destroy(ctx->ibo);
+	spel_gfx_ring_destroy(ctx->vring);
+	spel_gfx_ring_destroy(ctx->iring);
 	spel_memory_free(ctx->default_canvas);
 	spel_gfx_cmdlist_destroy(ctx->command_list);
 	spel_memory_free(ctx);
@@ -332,23 +318,32 @@ spel_hidden void spel_canvas_ctx_flush(spel_canvas_context* ctx)
 		return; // nothing to draw
 	}
 
-	// upload scratch buffers to gpu
-	spel_gfx_cmd_buffer_update(ctx->command_list, ctx->vbo, ctx->verts,
-							   ctx->vert_count * sizeof(spel_canvas_vertex), 0);
-	spel_gfx_cmd_buffer_update(ctx->command_list, ctx->ibo, ctx->indices,
-							   ctx->index_count * sizeof(uint32_t), 0);
+	// straight into mapped memory, no copy through the cmdlist or the driver
+	size_t vert_size = ctx->vert_count * sizeof(spel_canvas_vertex);
+	size_t index_size = ctx->index_count * sizeof(uint32_t);
+	spel_gfx_ring_slice verts = spel_gfx_ring_alloc(ctx->vring, vert_size, 16);
+	spel_gfx_ring_slice indices = spel_gfx_ring_alloc(ctx->iring, index_size, 4);
+	if (verts.data == NULL || indices.data == NULL)
+	{
+		ctx->vert_count = 0;
+		ctx->index_count = 0;
+		return;
+	}
+
+	memcpy(verts.data, ctx->verts, vert_size);
+	memcpy(indices.data, ctx->indices, index_size);
 
 	// bind everything
 	spel_gfx_cmd_bind_pipeline(ctx->command_list, ctx->pipeline);
 
-	spel_gfx_cmd_uniform_block_update(ctx->command_list, ctx->ubuffer_frame,
-									  &ctx->frame_data, sizeof(ctx->frame_data), 0);
-	spel_gfx_cmd_bind_shader_buffer(ctx->command_list, ctx->ubuffer_frame);
+	spel_gfx_cmd_uniform_push(ctx->command_list, ctx->ubuffer_frame, &ctx->frame_data,
+							  sizeof(ctx->frame_data));
 
 	spel_canvas_mode_flush(ctx->mode, ctx);
 
-	spel_gfx_cmd_bind_vertex(ctx->command_list, 0, ctx->vbo, 0);
-	spel_gfx_cmd_bind_index(ctx->command_list, ctx->ibo, SPEL_GFX_INDEX_U32, 0);
+	spel_gfx_cmd_bind_vertex(ctx->command_list, 0, verts.buffer, verts.offset);
+	spel_gfx_cmd_bind_index(ctx->command_list, indices.buffer, SPEL_GFX_INDEX_U32,
+							indices.offset);
 	spel_gfx_cmd_bind_texture(ctx->command_list, 0, ctx->batch_texture);
 	spel_gfx_cmd_bind_sampler(ctx->command_list, 0, ctx->sampler);
 
@@ -598,9 +593,6 @@ void spel_canvas_ensure_capacity(int vertsNeeded, int indicesNeeded)
 
 	spel.gfx->canvas_ctx->vert_cap = new_cap;
 	spel.gfx->canvas_ctx->index_cap = (new_cap * 3) / 2;
-
-	spel_gfx_buffer_resize(spel.gfx->canvas_ctx->vbo, new_cap, true);
-	spel_gfx_buffer_resize(spel.gfx->canvas_ctx->ibo, (new_cap * 3) / 2, true);
 }
 
 void spel_canvas_sampling_set(spel_gfx_sampler_filter filter)
@@ -899,10 +891,10 @@ spel_hidden void spel_canvas_mode_flush(spel_canvas_mode mode, spel_canvas_conte
 	case SPEL_CANVAS_TEXT:
 	{
 		// Lazy-create in case the buffer was not made during batch setup
-		if (ctx->font_ubuffer.buffer == NULL)
+		if (ctx->font_ubuffer.size == 0)
 		{
-			ctx->font_ubuffer = spel_gfx_uniform_buffer_create(ctx->pipeline, "DrawData");
-			if (ctx->font_ubuffer.buffer == NULL)
+			ctx->font_ubuffer = spel_gfx_uniform_block_get(ctx->pipeline, "DrawData");
+			if (ctx->font_ubuffer.size == 0)
 			{
 				spel_error(SPEL_ERR_INVALID_RESOURCE,
 						   "text draw skipped: DrawData block unavailable");
@@ -921,9 +913,8 @@ spel_hidden void spel_canvas_mode_flush(spel_canvas_mode mode, spel_canvas_conte
 			ctx->index_count = 0;
 			break;
 		}
-		spel_gfx_cmd_uniform_block_update(ctx->command_list, ctx->font_ubuffer,
-										  &ctx->font_data, sizeof(ctx->font_data), 0);
-		spel_gfx_cmd_bind_shader_buffer(ctx->command_list, ctx->font_ubuffer);
+		spel_gfx_cmd_uniform_push(ctx->command_list, ctx->font_ubuffer, &ctx->font_data,
+								  sizeof(ctx->font_data));
 		break;
 	}
 	}
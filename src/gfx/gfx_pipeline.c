@@ -5,6 +5,7 @@
 #include "gfx/gfx_shader.h"
 #include "gfx/gfx_types.h"
 #include "gfx_internal_shaders.h"
+#include "utils/internal/xxhash.h"
 #include <string.h>
 
 spel_hidden int32_t spel_gfx_find_block_by_set_binding(spel_gfx_shader_block* blocks,
@@ -13,6 +14,7 @@ spel_hidden int32_t spel_gfx_find_sampler_by_set_binding(spel_gfx_shader_uniform
 												   uint32_t count, uint32_t binding, uint32_t set);
 spel_hidden void spel_gfx_copy_block(spel_gfx_shader_block* dest,
 								   const spel_gfx_shader_block* src);
+static void spel_gfx_reflection_lookup_build(spel_gfx_pipeline pipeline);
 spel_hidden void spel_gfx_copy_sampler(spel_gfx_shader_uniform* dest,
 									 const spel_gfx_shader_uniform* src);
 spel_hidden void spel_gfx_verify_block_compatibility(spel_gfx_shader_block* existing,
@@ -27,6 +29,7 @@ spel_api spel_gfx_pipeline_desc spel_gfx_pipeline_default()
 	desc.vertex_shader = (spel_gfx_shader)0;
 	desc.fragment_shader = (spel_gfx_shader)0;
 	desc.geometry_shader = (spel_gfx_shader)0;
+	desc.compute_shader = (spel_gfx_shader)0;
 
 	desc.vertex_layout.attribs = NULL;
 	desc.vertex_layout.attrib_count = 0;
@@ -150,6 +153,8 @@ spel_api spel_gfx_pipeline_desc spel_gfx_pipeline_fullscreen(spel_gfx_context ct
 	{
 		spel_gfx_shader_desc vertex_desc;
 		vertex_desc.shader_source = SPEL_GFX_SHADER_STATIC;
+		vertex_desc.constants = NULL;
+		vertex_desc.constant_count = 0;
 		vertex_desc.debug_name = "spel_internal_fullscreen_vertex";
 		vertex_desc.source = spel_internal_fullscreen_vert_spv;
 		vertex_desc.source_size = spel_internal_fullscreen_vert_spv_len;
@@ -178,6 +183,8 @@ spel_api spel_gfx_pipeline_desc spel_gfx_pipeline_default_2d(spel_gfx_context ct
 	{
 		spel_gfx_shader_desc vertex_desc;
 		vertex_desc.shader_source = SPEL_GFX_SHADER_STATIC;
+		vertex_desc.constants = NULL;
+		vertex_desc.constant_count = 0;
 		vertex_desc.debug_name = "spel_internal_2d_vertex";
 		vertex_desc.source = spel_internal_2d_vert_spv;
 		vertex_desc.source_size = spel_internal_2d_vert_spv_len;
@@ -190,6 +197,8 @@ spel_api spel_gfx_pipeline_desc spel_gfx_pipeline_default_2d(spel_gfx_context ct
 	{
 		spel_gfx_shader_desc fragment_desc;
 		fragment_desc.shader_source = SPEL_GFX_SHADER_STATIC;
+		fragment_desc.constants = NULL;
+		fragment_desc.constant_count = 0;
 		fragment_desc.debug_name = "spel_internal_2d_fragment";
 		fragment_desc.source = spel_internal_2d_frag_spv;
 		fragment_desc.source_size = spel_internal_2d_frag_spv_len;
@@ -227,6 +236,13 @@ spel_api spel_gfx_pipeline_desc spel_gfx_pipeline_default_2d(spel_gfx_context ct
 	return desc;
 }
 
+spel_api spel_gfx_pipeline_desc spel_gfx_pipeline_compute(spel_gfx_shader compute)
+{
+	spel_gfx_pipeline_desc desc = spel_gfx_pipeline_default();
+	desc.compute_shader = compute;
+	return desc;
+}
+
 spel_hidden extern void spel_gfx_pipeline_merge_reflections(spel_gfx_pipeline pipeline,
 														  spel_gfx_shader* shaders,
 														  uint32_t shaderCount)
@@ -252,18 +268,18 @@ spel_hidden extern void spel_gfx_pipeline_merge_reflections(spel_gfx_pipeline pi
 
 	if (total_ubos > 0)
 	{
-		all_ubos = spel_memory_malloc(total_ubos * sizeof(spel_gfx_shader_block),
+		all_ubos = spel_memory_calloc(total_ubos, sizeof(spel_gfx_shader_block),
 									  SPEL_MEM_TAG_GFX);
 	}
 	if (total_ssbos > 0)
 	{
-		all_ssbos = spel_memory_malloc(total_ssbos * sizeof(spel_gfx_shader_block),
+		all_ssbos = spel_memory_calloc(total_ssbos, sizeof(spel_gfx_shader_block),
 									   SPEL_MEM_TAG_GFX);
 	}
 	if (total_samplers > 0)
 	{
-		all_samplers = spel_memory_malloc(
-			total_samplers * sizeof(spel_gfx_shader_uniform), SPEL_MEM_TAG_GFX);
+		all_samplers = spel_memory_calloc(
+			total_samplers, sizeof(spel_gfx_shader_uniform), SPEL_MEM_TAG_GFX);
 	}
 
 	uint32_t ubo_idx = 0;
@@ -335,6 +351,175 @@ spel_hidden extern void spel_gfx_pipeline_merge_reflections(spel_gfx_pipeline pi
 	pipeline->reflection.storage_count = ssbo_idx;
 	pipeline->reflection.samplers = all_samplers;
 	pipeline->reflection.sampler_count = sampler_idx;
+
+	spel_gfx_reflection_lookup_build(pipeline);
+}
+
+spel_hidden uint64_t spel_gfx_reflect_name_hash(const char* name)
+{
+	return XXH3_64bits(name, strlen(name));
+}
+
+static void spel_gfx_reflection_table_init(spel_gfx_reflection_table* table,
+										   uint32_t count)
+{
+	// kept at most half full, probes stay short
+	uint32_t capacity = 8;
+	while (capacity < count * 2)
+	{
+		capacity *= 2;
+	}
+
+	table->slots = spel_memory_calloc(capacity, sizeof(*table->slots), SPEL_MEM_TAG_GFX);
+	table->capacity = capacity;
+}
+
+// the first entry for a key wins, same as the linear scans this replaced
+static void spel_gfx_reflection_table_insert(spel_gfx_reflection_table* table,
+											 uint64_t key, uint32_t block, uint32_t member,
+											 bool storage)
+{
+	uint32_t mask = table->capacity - 1;
+	uint32_t index = (uint32_t)key & mask;
+
+	while (table->slots[index].used)
+	{
+		if (table->slots[index].key == key)
+		{
+			return;
+		}
+		index = (index + 1) & mask;
+	}
+
+	table->slots[index] = (spel_gfx_reflection_slot){.key = key,
+													 .block = (uint16_t)block,
+													 .member = (uint16_t)member,
+													 .storage = storage,
+													 .used = true};
+}
+
+static void spel_gfx_reflection_lookup_add(spel_gfx_pipeline pipeline,
+										   spel_gfx_shader_block* blocks, uint32_t count,
+										   bool storage)
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		spel_gfx_shader_block* block = &blocks[i];
+		spel_gfx_reflection_table_insert(&pipeline->lookup.blocks, block->name_hash, i,
+										 SPEL_GFX_REFLECT_BLOCK, storage);
+		spel_gfx_reflection_table_insert(&pipeline->lookup.locations, block->location, i,
+										 SPEL_GFX_REFLECT_BLOCK, storage);
+
+		for (uint32_t m = 0; m < block->member_count; m++)
+		{
+			spel_gfx_reflection_table_insert(&pipeline->lookup.members,
+											 block->members[m].name_hash, i, m, storage);
+		}
+	}
+}
+
+static void spel_gfx_reflection_lookup_build(spel_gfx_pipeline pipeline)
+{
+	spel_gfx_shader_reflection* refl = &pipeline->reflection;
+	uint32_t block_count = refl->uniform_count + refl->storage_count;
+	uint32_t member_count = 0;
+
+	for (uint32_t i = 0; i < refl->uniform_count; i++)
+	{
+		member_count += refl->uniforms[i].member_count;
+	}
+
+	for (uint32_t i = 0; i < refl->storage_count; i++)
+	{
+		member_count += refl->storage[i].member_count;
+	}
+
+	spel_gfx_reflection_table_init(&pipeline->lookup.blocks, block_count);
+	spel_gfx_reflection_table_init(&pipeline->lookup.locations, block_count);
+	spel_gfx_reflection_table_init(&pipeline->lookup.members, member_count);
+
+	spel_gfx_reflection_lookup_add(pipeline, refl->uniforms, refl->uniform_count, false);
+	spel_gfx_reflection_lookup_add(pipeline, refl->storage, refl->storage_count, true);
+}
+
+spel_hidden const spel_gfx_reflection_slot*
+spel_gfx_reflection_find(const spel_gfx_reflection_table* table, uint64_t key)
+{
+	if (table->capacity == 0)
+	{
+		return NULL;
+	}
+
+	uint32_t mask = table->capacity - 1;
+	for (uint32_t index = (uint32_t)key & mask; table->slots[index].used;
+		 index = (index + 1) & mask)
+	{
+		if (table->slots[index].key == key)
+		{
+			return &table->slots[index];
+		}
+	}
+
+	return NULL;
+}
+
+spel_hidden spel_gfx_shader_block*
+spel_gfx_reflection_block(spel_gfx_pipeline pipeline,
+						  const spel_gfx_reflection_slot* slot)
+{
+	if (slot == NULL)
+	{
+		return NULL;
+	}
+
+	return slot->storage ? &pipeline->reflection.storage[slot->block]
+						 : &pipeline->reflection.uniforms[slot->block];
+}
+
+static void spel_gfx_reflection_lookup_free(spel_gfx_pipeline pipeline)
+{
+	spel_memory_free(pipeline->lookup.blocks.slots);
+	spel_memory_free(pipeline->lookup.members.slots);
+	spel_memory_free(pipeline->lookup.locations.slots);
+	memset(&pipeline->lookup, 0, sizeof(pipeline->lookup));
+}
+
+static void spel_gfx_free_blocks(spel_gfx_shader_block* blocks, uint32_t count)
+{
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		spel_gfx_shader_block* block = &blocks[i];
+		if (block->members)
+		{
+			for (uint32_t m = 0; m < block->member_count; ++m)
+			{
+				spel_memory_free(block->members[m].name);
+			}
+			spel_memory_free(block->members);
+		}
+		spel_memory_free(block->name);
+	}
+}
+
+// frees the merged reflection and its lookup tables, leaving the pipeline ready
+// for another merge
+spel_hidden void spel_gfx_pipeline_reflection_free(spel_gfx_pipeline pipeline)
+{
+	spel_gfx_shader_reflection* refl = &pipeline->reflection;
+	spel_gfx_reflection_lookup_free(pipeline);
+
+	spel_gfx_free_blocks(refl->uniforms, refl->uniform_count);
+	spel_gfx_free_blocks(refl->storage, refl->storage_count);
+
+	for (uint32_t i = 0; i < refl->sampler_count; ++i)
+	{
+		spel_memory_free(refl->samplers[i].name);
+	}
+
+	spel_memory_free(refl->samplers);
+	spel_memory_free(refl->storage);
+	spel_memory_free(refl->uniforms);
+	memset(refl, 0, sizeof(*refl));
 }
 
 spel_hidden int32_t spel_gfx_find_block_by_set_binding(spel_gfx_shader_block* blocks,
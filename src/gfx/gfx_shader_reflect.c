@@ -3,6 +3,7 @@
 #include "gfx/gfx_internal.h"
 #include "utils/internal/spirv_reflect.h"
 #include <stdio.h>
+#include <string.h>
 
 #define SPIR_V_MAGIC 0x07230203
 #define OP_DECORATE 71
@@ -43,6 +44,9 @@ spel_hidden void spel_gfx_flatten_block_members(SpvReflectBlockVariable* var,
 											  const char* prefix,
 											  spel_gfx_shader_uniform* uniforms,
 											  uint32_t* index, spel_gfx_shader shader);
+static void spel_gfx_reflect_constants(SpvReflectShaderModule* module,
+									   spel_gfx_shader shader,
+									   const spel_gfx_shader_desc* desc);
 
 spel_hidden void spel_gfx_shader_reflect(spel_gfx_shader shader, spel_gfx_shader_desc* desc)
 {
@@ -58,6 +62,7 @@ spel_hidden void spel_gfx_shader_reflect(spel_gfx_shader shader, spel_gfx_shader
 
 	shader->entry = spel_memory_strdup(module.entry_point_name, SPEL_MEM_TAG_GFX);
 	shader->type = spel_gfx_spvreflect_stage_to_spel(module.shader_stage);
+	spel_gfx_reflect_constants(&module, shader, desc);
 
 	uint32_t binding_count = 0;
 	if (spvReflectEnumerateDescriptorBindings(&module, &binding_count, NULL) !=
@@ -108,20 +113,20 @@ spel_hidden void spel_gfx_shader_reflect(spel_gfx_shader shader, spel_gfx_shader
 
 	if (ubo_count > 0)
 	{
-		shader->reflection.uniforms = spel_memory_malloc(
-			ubo_count * sizeof(spel_gfx_shader_block), SPEL_MEM_TAG_GFX);
+		shader->reflection.uniforms = spel_memory_calloc(
+			ubo_count, sizeof(spel_gfx_shader_block), SPEL_MEM_TAG_GFX);
 	}
 
 	if (ssbo_count > 0)
 	{
-		shader->reflection.storage = spel_memory_malloc(
-			ssbo_count * sizeof(spel_gfx_shader_block), SPEL_MEM_TAG_GFX);
+		shader->reflection.storage = spel_memory_calloc(
+			ssbo_count, sizeof(spel_gfx_shader_block), SPEL_MEM_TAG_GFX);
 	}
 
 	if (sampler_count > 0)
 	{
-		shader->reflection.samplers = spel_memory_malloc(
-			sampler_count * sizeof(spel_gfx_shader_uniform), SPEL_MEM_TAG_GFX);
+		shader->reflection.samplers = spel_memory_calloc(
+			sampler_count, sizeof(spel_gfx_shader_uniform), SPEL_MEM_TAG_GFX);
 	}
 
 	uint32_t ubo_idx = 0;
@@ -175,6 +180,79 @@ spel_hidden void spel_gfx_shader_reflect(spel_gfx_shader shader, spel_gfx_shader
 	spvReflectDestroyShaderModule(&module);
 }
 
+// picks up every specialization constant with its default, then applies the
+// desc's overrides on top
+static void spel_gfx_reflect_constants(SpvReflectShaderModule* module,
+									   spel_gfx_shader shader,
+									   const spel_gfx_shader_desc* desc)
+{
+	uint32_t count = 0;
+	if (spvReflectEnumerateSpecializationConstants(module, &count, NULL) !=
+			SPV_REFLECT_RESULT_SUCCESS ||
+		count == 0)
+	{
+		if (desc->constant_count > 0)
+		{
+			spel_warn("shader %s has no specialization constants to override",
+					  desc->debug_name);
+		}
+		return;
+	}
+
+	SpvReflectSpecializationConstant** constants =
+		(SpvReflectSpecializationConstant**)spel_memory_malloc(
+			count * sizeof(*constants), SPEL_MEM_TAG_GFX);
+	spvReflectEnumerateSpecializationConstants(module, &count, constants);
+
+	shader->reflection.constants = spel_memory_calloc(
+		count, sizeof(spel_gfx_shader_spec_constant), SPEL_MEM_TAG_GFX);
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		// gl only takes 32 bit values, 64 bit constants just keep their default
+		if (constants[i]->default_value_size != sizeof(uint32_t))
+		{
+			continue;
+		}
+
+		spel_gfx_shader_spec_constant* constant =
+			&shader->reflection.constants[shader->reflection.constant_count++];
+		constant->name = spel_memory_strdup(constants[i]->name ? constants[i]->name : "",
+											SPEL_MEM_TAG_GFX);
+		constant->id = constants[i]->constant_id;
+		memcpy(&constant->value, constants[i]->default_value, sizeof(uint32_t));
+	}
+
+	spel_memory_free((void*)constants);
+	count = shader->reflection.constant_count;
+
+	for (uint32_t i = 0; i < desc->constant_count; i++)
+	{
+		const spel_gfx_shader_constant* override = &desc->constants[i];
+		spel_gfx_shader_spec_constant* match = NULL;
+
+		for (uint32_t c = 0; c < count && match == NULL; c++)
+		{
+			spel_gfx_shader_spec_constant* constant = &shader->reflection.constants[c];
+			if (override->name ? strcmp(constant->name, override->name) == 0
+							   : constant->id == override->id)
+			{
+				match = constant;
+			}
+		}
+
+		if (match == NULL)
+		{
+			spel_warn("shader %s has no specialization constant %s (id %u)",
+					  desc->debug_name, override->name ? override->name : "",
+					  override->id);
+			continue;
+		}
+
+		match->value = override->value;
+	}
+}
+
 spel_hidden void spel_gfx_reflect_fill_block(spel_gfx_shader_block* block,
 										   SpvReflectDescriptorBinding* binding,
 										   spel_gfx_buffer_type type,
@@ -183,6 +261,7 @@ spel_hidden void spel_gfx_reflect_fill_block(spel_gfx_shader_block* block,
 {
 	block->name =
 		spel_memory_strdup(binding->type_description->type_name, SPEL_MEM_TAG_GFX);
+	block->name_hash = spel_gfx_reflect_name_hash(block->name);
 	block->binding = binding->binding;
 	block->size = binding->block.size;
 	block->set = binding->set;
@@ -190,7 +269,7 @@ spel_hidden void spel_gfx_reflect_fill_block(spel_gfx_shader_block* block,
 
 	uint32_t total_members = spel_gfx_count_block_members(&binding->block, desc);
 
-	block->members = spel_memory_malloc(total_members * sizeof(spel_gfx_shader_uniform),
+	block->members = spel_memory_calloc(total_members, sizeof(spel_gfx_shader_uniform),
 										SPEL_MEM_TAG_GFX);
 	block->member_count = 0;
 
@@ -245,6 +324,7 @@ spel_hidden void spel_gfx_flatten_block_members(SpvReflectBlockVariable* var,
 
 		spel_gfx_shader_uniform* uniform = &uniforms[(*index)++];
 		uniform->name = spel_memory_strdup(full_name, SPEL_MEM_TAG_GFX);
+		uniform->name_hash = spel_gfx_reflect_name_hash(uniform->name);
 		uniform->offset = var->offset;
 		if (var->array.dims_count > 0)
 		{
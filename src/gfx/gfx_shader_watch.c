@@ -0,0 +1,206 @@
+#include "core/log.h"
+#include "core/memory.h"
+#include "gfx/gfx_internal.h"
+#include "utils/path.h"
+#include <string.h>
+
+#ifdef __linux__
+#	include <errno.h>
+#	include <sys/inotify.h>
+#	include <unistd.h>
+
+typedef struct
+{
+	spel_gfx_shader shader;
+	char* path;
+	const char* name; // points into path, what inotify reports for the directory
+	int wd;
+	bool dirty;
+} spel_gfx_watched_shader;
+
+typedef struct spel_gfx_shader_watch_t
+{
+	int fd;
+	spel_gfx_watched_shader* shaders;
+	uint32_t count;
+	uint32_t capacity;
+} spel_gfx_shader_watch_t;
+
+spel_hidden void spel_gfx_shader_watch_init(spel_gfx_context ctx)
+{
+	int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (fd < 0)
+	{
+		spel_warn("shader hot reload is off, inotify failed: %s", strerror(errno));
+		return;
+	}
+
+	ctx->shader_watch = spel_memory_calloc(1, sizeof(spel_gfx_shader_watch_t),
+										   SPEL_MEM_TAG_GFX);
+	ctx->shader_watch->fd = fd;
+}
+
+spel_hidden void spel_gfx_shader_watch_shutdown(spel_gfx_context ctx)
+{
+	spel_gfx_shader_watch watch = ctx->shader_watch;
+	if (watch == NULL)
+	{
+		return;
+	}
+
+	for (uint32_t i = 0; i < watch->count; i++)
+	{
+		spel_memory_free(watch->shaders[i].path);
+	}
+
+	close(watch->fd);
+	spel_memory_free(watch->shaders);
+	spel_memory_free(watch);
+	ctx->shader_watch = NULL;
+}
+
+// the directory gets watched rather than the file, editors and sh2spv alike
+// replace the file, and a watch on the old inode would go quiet after that
+spel_hidden void spel_gfx_shader_watch_add(spel_gfx_shader shader, const char* path)
+{
+	spel_gfx_shader_watch watch = shader->ctx->shader_watch;
+	if (watch == NULL)
+	{
+		return;
+	}
+
+	char dir[512];
+	spel_path_dirname(path, dir, sizeof(dir));
+
+	int wd = inotify_add_watch(watch->fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO);
+	if (wd < 0)
+	{
+		spel_warn("can't watch %s for changes: %s", dir, strerror(errno));
+		return;
+	}
+
+	if (watch->count == watch->capacity)
+	{
+		watch->capacity = watch->capacity ? watch->capacity * 2 : 16;
+		watch->shaders = spel_memory_realloc(
+			watch->shaders, watch->capacity * sizeof(*watch->shaders), SPEL_MEM_TAG_GFX);
+	}
+
+	spel_gfx_watched_shader* entry = &watch->shaders[watch->count++];
+	entry->shader = shader;
+	entry->path = spel_memory_strdup(path, SPEL_MEM_TAG_GFX);
+	entry->name = spel_path_filename(entry->path);
+	entry->wd = wd;
+	entry->dirty = false;
+}
+
+spel_hidden void spel_gfx_shader_watch_remove(spel_gfx_shader shader)
+{
+	spel_gfx_shader_watch watch = shader->ctx->shader_watch;
+	if (watch == NULL)
+	{
+		return;
+	}
+
+	for (uint32_t i = 0; i < watch->count; i++)
+	{
+		if (watch->shaders[i].shader != shader)
+		{
+			continue;
+		}
+
+		int wd = watch->shaders[i].wd;
+		spel_memory_free(watch->shaders[i].path);
+		watch->shaders[i] = watch->shaders[--watch->count];
+
+		// inotify hands out one wd per directory, keep it while others still use it
+		for (uint32_t j = 0; j < watch->count; j++)
+		{
+			if (watch->shaders[j].wd == wd)
+			{
+				return;
+			}
+		}
+
+		inotify_rm_watch(watch->fd, wd);
+		return;
+	}
+}
+
+// drains the events and reloads every changed shader once, however many writes
+// it took to get there
+spel_hidden void spel_gfx_shader_watch_poll(spel_gfx_context ctx)
+{
+	spel_gfx_shader_watch watch = ctx->shader_watch;
+	if (watch == NULL || watch->count == 0)
+	{
+		return;
+	}
+
+	_Alignas(struct inotify_event) char buf[4096];
+	bool changed = false;
+	ssize_t len;
+
+	while ((len = read(watch->fd, buf, sizeof(buf))) > 0)
+	{
+		const struct inotify_event* event;
+		for (char* ptr = buf; ptr < buf + len;
+			 ptr += sizeof(struct inotify_event) + event->len)
+		{
+			event = (const struct inotify_event*)ptr;
+			if (event->len == 0)
+			{
+				continue;
+			}
+
+			for (uint32_t i = 0; i < watch->count; i++)
+			{
+				spel_gfx_watched_shader* entry = &watch->shaders[i];
+				if (entry->wd == event->wd && strcmp(entry->name, event->name) == 0)
+				{
+					entry->dirty = true;
+					changed = true;
+				}
+			}
+		}
+	}
+
+	if (!changed)
+	{
+		return;
+	}
+
+	for (uint32_t i = 0; i < watch->count; i++)
+	{
+		if (watch->shaders[i].dirty)
+		{
+			watch->shaders[i].dirty = false;
+			spel_gfx_shader_reload(watch->shaders[i].shader, watch->shaders[i].path);
+		}
+	}
+}
+
+#else
+
+spel_hidden void spel_gfx_shader_watch_init(spel_gfx_context ctx)
+{
+	spel_warn("shader hot reload needs inotify, it's only there on linux");
+}
+
+spel_hidden void spel_gfx_shader_watch_shutdown(spel_gfx_context ctx)
+{
+}
+
+spel_hidden void spel_gfx_shader_watch_add(spel_gfx_shader shader, const char* path)
+{
+}
+
+spel_hidden void spel_gfx_shader_watch_remove(spel_gfx_shader shader)
+{
+}
+
+spel_hidden void spel_gfx_shader_watch_poll(spel_gfx_context ctx)
+{
+}
+
+#endif
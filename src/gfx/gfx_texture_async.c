@@ -0,0 +1,391 @@
+#include "SDL3/SDL_mutex.h"
+#include "SDL3/SDL_thread.h"
+#include "core/entry.h"
+#include "core/log.h"
+#include "core/memory.h"
+#include "gfx/gfx_internal.h"
+#include "utils/internal/stb_image.h"
+#include "utils/time.h"
+#include <stdatomic.h>
+#include <string.h>
+
+#define SPEL_GFX_TEXTURE_MAX_WORKERS 8
+
+typedef enum
+{
+	SPEL_GFX_TEXTURE_JOB_QUEUED,
+	SPEL_GFX_TEXTURE_JOB_DECODING,
+	SPEL_GFX_TEXTURE_JOB_DECODED,
+} spel_gfx_texture_job_state;
+
+typedef struct spel_gfx_texture_job
+{
+	struct spel_gfx_texture_job* next;
+	spel_gfx_texture texture; // null once the texture got destroyed
+	spel_gfx_texture_load_desc desc;
+	spel_gfx_texture_job_state state;
+
+	char* path; // one of path or data
+	char* data;
+	size_t data_size;
+
+	// what the worker leaves for the upload, pixels is null when decoding failed
+	uint8_t* pixels;
+	uint8_t* upload;
+	spel_gfx_texture_desc result;
+} spel_gfx_texture_job;
+
+typedef struct spel_gfx_texture_loader_t
+{
+	SDL_Thread* threads[SPEL_GFX_TEXTURE_MAX_WORKERS];
+	uint32_t thread_count;
+
+	SDL_Mutex* lock;
+	SDL_Condition* wake;
+	bool quit;
+
+	// every job in submission order. jobs start decoding in that order too, so the
+	// queued ones are always the tail starting at `queued`
+	spel_gfx_texture_job* head;
+	spel_gfx_texture_job* tail;
+	spel_gfx_texture_job* queued;
+	_Atomic uint32_t decoded; // lets a frame with nothing to upload skip the lock
+} spel_gfx_texture_loader_t;
+
+static void spel_gfx_texture_job_free(spel_gfx_texture_job* job)
+{
+	if (job->upload != NULL && job->upload != job->pixels)
+	{
+		spel_memory_free(job->upload);
+	}
+
+	if (job->pixels != NULL)
+	{
+		stbi_image_free(job->pixels);
+	}
+
+	spel_memory_free(job->path);
+	spel_memory_free(job->data);
+	spel_memory_free(job);
+}
+
+// runs on a worker, touches nothing but the job
+static void spel_gfx_texture_job_decode(spel_gfx_texture_job* job)
+{
+	int w;
+	int h;
+	int comp;
+
+	if (job->path != NULL)
+	{
+		job->pixels = stbi_load(job->path, &w, &h, &comp, 0);
+	}
+	else
+	{
+		job->pixels = stbi_load_from_memory((uint8_t*)job->data, (int)job->data_size, &w,
+											&h, &comp, 0);
+		spel_memory_free(job->data);
+		job->data = NULL;
+	}
+
+	if (job->pixels == NULL)
+	{
+		spel_warn("couldn't decode %s: %s", job->path ? job->path : "texture data",
+				  stbi_failure_reason());
+		return;
+	}
+
+	// off the main thread the frame arena is out, so an rgb expansion always lands
+	// on the heap
+	job->upload =
+		spel_gfx_texture_decoded_desc(job->pixels, w, h, comp, &job->desc, &job->result);
+	if (job->upload == NULL)
+	{
+		stbi_image_free(job->pixels);
+		job->pixels = NULL;
+	}
+}
+
+static int spel_gfx_texture_worker(void* user)
+{
+	spel_gfx_texture_loader loader = user;
+
+	SDL_LockMutex(loader->lock);
+	for (;;)
+	{
+		while (!loader->quit && loader->queued == NULL)
+		{
+			SDL_WaitCondition(loader->wake, loader->lock);
+		}
+
+		if (loader->quit)
+		{
+			break;
+		}
+
+		spel_gfx_texture_job* job = loader->queued;
+		loader->queued = job->next;
+		job->state = SPEL_GFX_TEXTURE_JOB_DECODING;
+
+		SDL_UnlockMutex(loader->lock);
+		spel_gfx_texture_job_decode(job);
+		SDL_LockMutex(loader->lock);
+
+		job->state = SPEL_GFX_TEXTURE_JOB_DECODED;
+		loader->decoded++;
+	}
+	SDL_UnlockMutex(loader->lock);
+
+	return 0;
+}
+
+// one core stays with the render thread, the rest decode
+static spel_gfx_texture_loader spel_gfx_texture_loader_get(spel_gfx_context ctx)
+{
+	if (ctx->texture_loader != NULL)
+	{
+		return ctx->texture_loader;
+	}
+
+	spel_gfx_texture_loader loader =
+		spel_memory_calloc(1, sizeof(*loader), SPEL_MEM_TAG_GFX);
+	loader->lock = SDL_CreateMutex();
+	loader->wake = SDL_CreateCondition();
+
+	uint32_t workers = spel.hardware.cpu_cores > 1 ? spel.hardware.cpu_cores - 1 : 1;
+	if (workers > SPEL_GFX_TEXTURE_MAX_WORKERS)
+	{
+		workers = SPEL_GFX_TEXTURE_MAX_WORKERS;
+	}
+
+	for (uint32_t i = 0; i < workers; i++)
+	{
+		SDL_Thread* thread =
+			SDL_CreateThread(spel_gfx_texture_worker, "spel texture decode", loader);
+		if (thread == NULL)
+		{
+			spel_warn("couldn't start texture decode worker: %s", SDL_GetError());
+			break;
+		}
+		loader->threads[loader->thread_count++] = thread;
+	}
+
+	if (loader->thread_count == 0)
+	{
+		SDL_DestroyCondition(loader->wake);
+		SDL_DestroyMutex(loader->lock);
+		spel_memory_free(loader);
+		return NULL;
+	}
+
+	spel_debug("started %u texture decode workers", loader->thread_count);
+	ctx->texture_loader = loader;
+	return loader;
+}
+
+static spel_gfx_texture spel_gfx_texture_load_queue(spel_gfx_context ctx,
+													spel_gfx_texture_job* job)
+{
+	spel_gfx_texture_loader loader = spel_gfx_texture_loader_get(ctx);
+	spel_gfx_texture texture = ctx->vt->texture_view(ctx->checkerboard);
+
+	if (loader == NULL || texture == NULL)
+	{
+		spel_gfx_texture_job_free(job);
+		return texture != NULL ? texture : ctx->checkerboard;
+	}
+
+	texture->loading = true;
+	job->texture = texture;
+	job->state = SPEL_GFX_TEXTURE_JOB_QUEUED;
+
+	SDL_LockMutex(loader->lock);
+	if (loader->tail != NULL)
+	{
+		loader->tail->next = job;
+	}
+	else
+	{
+		loader->head = job;
+	}
+	loader->tail = job;
+
+	if (loader->queued == NULL)
+	{
+		loader->queued = job;
+	}
+	SDL_SignalCondition(loader->wake);
+	SDL_UnlockMutex(loader->lock);
+
+	return texture;
+}
+
+spel_api spel_gfx_texture
+spel_gfx_texture_load_async(spel_gfx_context ctx, const char* path,
+							const spel_gfx_texture_load_desc* desc)
+{
+	spel_gfx_texture_job* job = spel_memory_calloc(1, sizeof(*job), SPEL_MEM_TAG_GFX);
+	job->path = spel_memory_strdup(path, SPEL_MEM_TAG_GFX);
+	job->desc = *desc;
+
+	return spel_gfx_texture_load_queue(ctx, job);
+}
+
+spel_api spel_gfx_texture
+spel_gfx_texture_load_data_async(spel_gfx_context ctx, const char* data, size_t dataSize,
+								 const spel_gfx_texture_load_desc* desc)
+{
+	spel_gfx_texture_job* job = spel_memory_calloc(1, sizeof(*job), SPEL_MEM_TAG_GFX);
+	job->data = spel_memory_malloc(dataSize, SPEL_MEM_TAG_GFX);
+	memcpy(job->data, data, dataSize);
+	job->data_size = dataSize;
+	job->desc = *desc;
+
+	return spel_gfx_texture_load_queue(ctx, job);
+}
+
+spel_api bool spel_gfx_texture_loading(spel_gfx_texture texture)
+{
+	return texture->loading;
+}
+
+spel_api void spel_gfx_texture_load_budget(spel_gfx_context ctx, uint64_t budgetNs)
+{
+	ctx->texture_load_budget_ns = budgetNs;
+}
+
+static void spel_gfx_texture_job_finish(spel_gfx_context ctx, spel_gfx_texture_job* job)
+{
+	spel_gfx_texture texture = job->texture;
+	if (texture == NULL)
+	{
+		return;
+	}
+
+	texture->loading = false;
+	if (job->pixels == NULL || !ctx->vt->texture_replace(texture, &job->result))
+	{
+		// the view of the checker is still in place, so it just stays that
+		spel_warn("async load of %s failed, keeping the placeholder",
+				  job->path ? job->path : "texture data");
+	}
+}
+
+// uploads decoded jobs oldest first until the frame's budget runs out, the first
+// one always goes so a single huge texture can't stall the queue forever
+spel_hidden void spel_gfx_texture_loader_poll(spel_gfx_context ctx)
+{
+	spel_gfx_texture_loader loader = ctx->texture_loader;
+	if (loader == NULL || loader->decoded == 0)
+	{
+		return;
+	}
+
+	uint64_t start = spel_time_now_ns();
+
+	for (;;)
+	{
+		SDL_LockMutex(loader->lock);
+
+		spel_gfx_texture_job* prev = NULL;
+		spel_gfx_texture_job* job = loader->head;
+		while (job != NULL && job->state != SPEL_GFX_TEXTURE_JOB_DECODED)
+		{
+			prev = job;
+			job = job->next;
+		}
+
+		if (job != NULL)
+		{
+			if (prev != NULL)
+			{
+				prev->next = job->next;
+			}
+			else
+			{
+				loader->head = job->next;
+			}
+
+			if (loader->tail == job)
+			{
+				loader->tail = prev;
+			}
+			loader->decoded--;
+		}
+
+		SDL_UnlockMutex(loader->lock);
+
+		if (job == NULL)
+		{
+			break;
+		}
+
+		spel_gfx_texture_job_finish(ctx, job);
+		spel_gfx_texture_job_free(job);
+
+		if (spel_time_now_ns() - start >= ctx->texture_load_budget_ns)
+		{
+			break;
+		}
+	}
+}
+
+// the job might be on a worker right now, so it gets orphaned instead of freed
+spel_hidden void spel_gfx_texture_loader_cancel(spel_gfx_texture texture)
+{
+	spel_gfx_texture_loader loader = texture->ctx->texture_loader;
+	if (loader == NULL)
+	{
+		return;
+	}
+
+	SDL_LockMutex(loader->lock);
+	for (spel_gfx_texture_job* job = loader->head; job != NULL; job = job->next)
+	{
+		if (job->texture == texture)
+		{
+			job->texture = NULL;
+			break;
+		}
+	}
+	SDL_UnlockMutex(loader->lock);
+
+	texture->loading = false;
+}
+
+spel_hidden void spel_gfx_texture_loader_shutdown(spel_gfx_context ctx)
+{
+	spel_gfx_texture_loader loader = ctx->texture_loader;
+	if (loader == NULL)
+	{
+		return;
+	}
+
+	SDL_LockMutex(loader->lock);
+	loader->quit = true;
+	SDL_BroadcastCondition(loader->wake);
+	SDL_UnlockMutex(loader->lock);
+
+	for (uint32_t i = 0; i < loader->thread_count; i++)
+	{
+		SDL_WaitThread(loader->threads[i], NULL);
+	}
+
+	// whatever didn't land yet stays a checkerboard
+	spel_gfx_texture_job* job = loader->head;
+	while (job != NULL)
+	{
+		spel_gfx_texture_job* next = job->next;
+		if (job->texture != NULL)
+		{
+			job->texture->loading = false;
+		}
+		spel_gfx_texture_job_free(job);
+		job = next;
+	}
+
+	SDL_DestroyCondition(loader->wake);
+	SDL_DestroyMutex(loader->lock);
+	spel_memory_free(loader);
+	ctx->texture_loader = NULL;
+}
@@ -313,16 +313,16 @@ spel_hidden void spel_input_process_event(SDL_Event* event)
 
 spel_hidden void spel_input_init()
 {
-	spel.input = spel_memory_malloc(sizeof(*spel.input), SPEL_MEM_TAG_CORE);
+	spel.input = spel_memory_calloc(1, sizeof(*spel.input), SPEL_MEM_TAG_CORE);
 
 	spel.input->action_capacity = 4;
-	spel.input->actions = spel_memory_malloc(
-		sizeof(spel_action_t) * spel.input->action_capacity, SPEL_MEM_TAG_CORE);
+	spel.input->actions = spel_memory_calloc(
+		spel.input->action_capacity, sizeof(spel_action_t), SPEL_MEM_TAG_CORE);
 
 	for (size_t i = 0; i < SPEL_MAX_CONTROLLERS; i++)
 	{
 		spel.input->gamepads[i] =
-			spel_memory_malloc(sizeof(spel_gamepad_t), SPEL_MEM_TAG_CORE);
+			spel_memory_calloc(1, sizeof(spel_gamepad_t), SPEL_MEM_TAG_CORE);
 	}
 }
 
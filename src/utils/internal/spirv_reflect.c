@@ -279,7 +279,7 @@ static int SortCompareAccessedVariable(const void* a, const void* b)
 
 void* spv_reflect_calloc(size_t count, size_t size)
 {
-	return spel_memory_malloc(count * size, SPEL_MEM_TAG_MISC);
+	return spel_memory_calloc(count, size, SPEL_MEM_TAG_MISC);
 }
 
 //
@@ -0,0 +1,142 @@
+// allocation micro-benchmark. replays roughly what a busy canvas frame asks of
+// the allocator (path scratch growth, vertex/index reallocs, small objects and
+// formatted strings) so the tracked and thin allocators can be compared:
+//
+//   meson setup build-tracked -Dallocator=tracked
+//   meson setup build-thin -Dallocator=thin
+//   meson test -C build-<mode> --benchmark
+#include "core/entry.h"
+#include "core/memory.h"
+#include "core/types.h"
+#include "utils/time.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MEMBENCH_PATHS 64
+#define MEMBENCH_OBJECTS 256
+
+typedef struct
+{
+	float x;
+	float y;
+	uint32_t flags;
+} membench_point;
+
+static void membench_frame(uint64_t frame)
+{
+	// path builder: every path starts small and doubles as points come in
+	for (int p = 0; p < MEMBENCH_PATHS; p++)
+	{
+		size_t cap = 16;
+		membench_point* points =
+			spel_memory_malloc(cap * sizeof(membench_point), SPEL_MEM_TAG_GFX);
+
+		size_t count = 32 + ((frame + p) % 96);
+		for (size_t i = 0; i < count; i++)
+		{
+			if (i == cap)
+			{
+				cap *= 2;
+				points = spel_memory_realloc(points, cap * sizeof(membench_point),
+											 SPEL_MEM_TAG_GFX);
+			}
+
+			points[i].x = (float)i;
+			points[i].y = (float)p;
+			points[i].flags = 0;
+		}
+
+		spel_memory_free(points);
+	}
+
+	// short lived objects, freed out of order
+	void* objects[MEMBENCH_OBJECTS];
+	for (int i = 0; i < MEMBENCH_OBJECTS; i++)
+	{
+		objects[i] = spel_memory_calloc(1, 48 + ((i * 16) % 208), SPEL_MEM_TAG_MISC);
+	}
+
+	for (int i = 0; i < MEMBENCH_OBJECTS; i += 2)
+	{
+		spel_memory_free(objects[i]);
+	}
+
+	for (int i = 1; i < MEMBENCH_OBJECTS; i += 2)
+	{
+		spel_memory_free(objects[i]);
+	}
+
+	// vertex/index staging that gets thrown away every frame
+	uint8_t* verts = spel_memory_malloc(64 * 1024, SPEL_MEM_TAG_GFX);
+	uint8_t* indices = spel_memory_malloc(96 * 1024, SPEL_MEM_TAG_GFX);
+	verts[0] = indices[0] = (uint8_t)frame;
+	spel_memory_free(indices);
+	spel_memory_free(verts);
+
+	// text and debug labels
+	for (int i = 0; i < 32; i++)
+	{
+		char buf[64];
+		snprintf(buf, sizeof(buf), "label %d frame %llu", i, (unsigned long long)frame);
+		spel_memory_free(spel_memory_strdup(buf, SPEL_MEM_TAG_TEMP));
+	}
+}
+
+static int membench_run(int argc, const char** argv)
+{
+	uint64_t frames = 2000;
+	for (int i = 1; i + 1 < argc; i++)
+	{
+		if (strcmp(argv[i], "--frames") == 0)
+		{
+			frames = strtoull(argv[i + 1], NULL, 10);
+		}
+	}
+
+	if (frames == 0)
+	{
+		fprintf(stderr, "--frames needs a count above 0\n");
+		return 1;
+	}
+
+#ifdef SPEL_MEMORY_THIN
+	const char* mode = "thin";
+#else
+	const char* mode = "tracked";
+#endif
+
+	// warm up so the first slabs of the libc heap don't skew the numbers
+	for (uint64_t f = 0; f < 32; f++)
+	{
+		membench_frame(f);
+	}
+
+	uint64_t start = spel_time_now_ns();
+	for (uint64_t f = 0; f < frames; f++)
+	{
+		membench_frame(f);
+	}
+	uint64_t elapsed = spel_time_now_ns() - start;
+
+	double per_frame = (double)elapsed / (double)frames;
+	printf("allocator: %s\n", mode);
+	printf("frames:    %llu\n", (unsigned long long)frames);
+	printf("per frame: %.2f us\n", per_frame / 1000.0);
+
+	spel_memory_dump_terminal();
+	return 0;
+}
+
+#ifdef SP_WEAK_LINK
+// main lives in the library, bail out before a window is ever opened
+void spel_conf()
+{
+	exit(membench_run((int)spel.process.argc, spel.process.argv));
+}
+#else
+int main(int argc, const char** argv)
+{
+	return membench_run(argc, argv);
+}
+#endif
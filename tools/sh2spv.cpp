@@ -10,6 +10,7 @@
 #endif
 
 #include <algorithm>
+#include <array>
 #include <cctype>
 #include <cstdio>
 #include <cstdlib>
@@ -88,6 +89,9 @@ struct shader_manifest_entry
 	std::string name;
 	std::string stage;
 	std::string path;
+	// workgroup size, compute only. the runtime needs it to turn item counts into
+	// group counts
+	std::optional<std::array<uint32_t, 3>> local_size;
 };
 
 auto stage_from_char(char stage) -> std::optional<stage_config>
@@ -458,7 +462,14 @@ auto write_manifest(const std::vector<shader_manifest_entry>& entries,
 		manifest << "		\"name\": \""
 				 << entry.name.substr(0, entry.name.find("_" + entry.stage)) << "\",\n";
 		manifest << "		\"stage\": \"" << entry.stage << "\",\n";
-		manifest << "		\"path\": \"" << entry.path << "\"\n";
+		manifest << "		\"path\": \"" << entry.path << "\"";
+		if (entry.local_size.has_value())
+		{
+			const auto& size = *entry.local_size;
+			manifest << ",\n		\"local_size\": [" << size[0] << ", " << size[1] << ", "
+					 << size[2] << "]";
+		}
+		manifest << "\n";
 		manifest << "	}";
 
 		if (i < entries.size() - 1)
@@ -909,12 +920,21 @@ auto main(int argc, const char** argv) -> int
 			f.write(reinterpret_cast<const char*>(spirv.data()),
 					spirv.size() * sizeof(unsigned int));
 
+			std::optional<std::array<uint32_t, 3>> local_size;
+			if (stageInfo.lang == EShLangCompute && program.buildReflection())
+			{
+				local_size = std::array<uint32_t, 3>{program.getLocalSize(0),
+													 program.getLocalSize(1),
+													 program.getLocalSize(2)};
+			}
+
 			manifest_entries.push_back(shader_manifest_entry{
 				.name = shaderName,
 				.stage = stageInfo.suffix,
 				.path = hasOutDir
 							? std::filesystem::relative(outputPath, out_dir).string()
-							: outputPath.string()});
+							: outputPath.string(),
+				.local_size = local_size});
 
 			return true;
 		};
@@ -955,6 +975,16 @@ auto main(int argc, const char** argv) -> int
 			auto output_path = build_output_path(stage_info.suffix, false, filename);
 			auto shader_name = std::filesystem::path(filename).stem().string();
 
+			// blur.comp.glsl has the stem blur.comp, which the manifest and spv2h
+			// would turn into a broken symbol, name it like a pragma stage instead
+			auto dotted = "." + stage_info.suffix;
+			if (!stage_info.suffix.empty() && shader_name.size() > dotted.size() &&
+				shader_name.ends_with(dotted))
+			{
+				shader_name = shader_name.substr(0, shader_name.size() - dotted.size()) +
+							  "_" + stage_info.suffix;
+			}
+
 			if (!compile_and_write(source, stage_info, output_path, shader_name))
 			{
 				result = -1;